@@ -1,118 +1,417 @@
 #ifndef A_STAR_H
 #define A_STAR_H
 
+#include "algorithms/connectivity.h"
+#include "utils/grid_view.h"
 #include "utils/point.h"
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
-#include <limits>
-#include <queue>
-#include <unordered_map>
-#include <unordered_set>
+#include <functional>
 #include <vector>
 
-template <typename T> class AStar {
-public:
-  struct Node {
-    Point point;
-    Point cameFrom;
-    int costFromStart = std::numeric_limits<int>::max();
-    int totalEstimatedCost = std::numeric_limits<int>::max();
-
-    Node() = default;
-    Node(Point p, Point cf, int g, int f)
-        : point(std::move(p)), cameFrom(std::move(cf)), costFromStart(g),
-          totalEstimatedCost(f) {}
-  };
-
-private:
+// Scratch state for AStar searches, sized to the largest grid seen so far
+// and reused from one search to the next. Per-cell entries are stamped with
+// the search generation, so starting a search costs O(1) rather than a
+// clear of every cell. Keep one workspace per thread (e.g. one per Orc) and
+// repeated searches stop allocating.
+class AStarWorkspace {
+  template <typename, Connectivity> friend class AStar;
+
+  std::uint32_t generation = 0;
+  // Cell was reached / expanded during the search stamped `generation`.
+  std::vector<std::uint32_t> openedStamp;
+  std::vector<std::uint32_t> closedStamp;
+  std::vector<int> costFromStart;
+  std::vector<int> cameFrom;
+  // Open list bucketed by f = g + h. With integer step costs and a
+  // consistent heuristic, f never decreases, so the search sweeps buckets
+  // upward.
+  std::vector<std::vector<int>> buckets;
+  std::size_t highestBucket = 0;
+
+  void prepare(std::size_t cellCount) {
+    if (cellCount > openedStamp.size()) {
+      openedStamp.assign(cellCount, 0);
+      closedStamp.assign(cellCount, 0);
+      costFromStart.resize(cellCount);
+      cameFrom.resize(cellCount);
+    }
+    if (++generation == 0) {
+      // Stamps wrapped around; forget every old search once
+      std::fill(openedStamp.begin(), openedStamp.end(), 0);
+      std::fill(closedStamp.begin(), closedStamp.end(), 0);
+      generation = 1;
+    }
+    for (std::size_t f = 0; f <= highestBucket && f < buckets.size(); ++f) {
+      buckets[f].clear();
+    }
+    highestBucket = 0;
+  }
+
+  bool isOpened(int cell) const { return openedStamp[cell] == generation; }
+  bool isClosed(int cell) const { return closedStamp[cell] == generation; }
+
+  void open(int cell, int cost, int parent, std::size_t f) {
+    openedStamp[cell] = generation;
+    costFromStart[cell] = cost;
+    cameFrom[cell] = parent;
+    if (f >= buckets.size()) {
+      buckets.resize(f + 1);
+    }
+    buckets[f].push_back(cell);
+    highestBucket = std::max(highestBucket, f);
+  }
+};
+
+enum class AStarMode {
+  Classic,  // Every cell is a node
+  JumpPoint // Jump point search, with the class's connectivity
+};
+
+// A* over a grid. Grid is anything exposing getWidth(), getHeight() and
+// operator()(x, y) returning a T: a GridView<const T>, a map CellLayer, ...
+//
+// Four-connected searches take unit steps under a Manhattan heuristic.
+// Eight-connected ones also step diagonally, like monsters do, at an
+// integer cost of 14 against 10 for a straight step, under the octile
+// heuristic; a diagonal step may not cut past a blocked corner.
+//
+// The jump point mode only puts cells where the route may turn on the open
+// list and scan straight runs in between, so crossing an open room costs a
+// handful of expansions instead of one per cell. Every mode returns the
+// full cell-by-cell path, start and end included.
+template <typename T, Connectivity connectivity = Connectivity::Four>
+class AStar {
   std::deque<Point> bestPath;
   std::function<bool(T)> isNavigable;
+  std::size_t expandedNodes = 0;
 
-  std::vector<Point> getNeighbors(const Point &p,
-                                  const std::vector<std::vector<T>> &grid) {
-    std::vector<Point> neighbors;
-    const auto px = p.x;
-    const auto py = p.y;
+  static constexpr bool eightWay = connectivity == Connectivity::Eight;
+  // 8-connected searches scale costs so a diagonal step (14) stays an
+  // integer close to sqrt(2) straight steps (10).
+  static constexpr int straightCost = 10;
+  static constexpr int diagonalCost = 14;
 
-    if (px > 0 && isNavigable(grid[py][px - 1]))
-      neighbors.emplace_back(px - 1, py);
+  // Copies a nested grid into one contiguous buffer so it can be viewed.
+  static std::vector<T> flatten(const std::vector<std::vector<T>> &grid) {
+    std::vector<T> cells;
+    const std::size_t width = grid.empty() ? 0 : grid[0].size();
+    cells.reserve(width * grid.size());
+    for (const auto &row : grid) {
+      cells.insert(cells.end(), row.begin(), row.end());
+    }
+    return cells;
+  }
 
-    if (px < grid[0].size() - 1 && isNavigable(grid[py][px + 1]))
-      neighbors.emplace_back(px + 1, py);
+  static int heuristic(int x, int y, const Point &end) {
+    return std::abs(x - end.x) + std::abs(y - end.y);
+  }
 
-    if (py > 0 && isNavigable(grid[py - 1][px]))
-      neighbors.emplace_back(px, py - 1);
+  // Octile distance in scaled costs.
+  static int octileHeuristic(int x, int y, const Point &end) {
+    const int dx = std::abs(x - end.x);
+    const int dy = std::abs(y - end.y);
+    return straightCost * std::max(dx, dy) +
+           (diagonalCost - straightCost) * std::min(dx, dy);
+  }
+
+  static int sign(int value) { return (value > 0) - (value < 0); }
 
-    if (py < grid.size() - 1 && isNavigable(grid[py + 1][px]))
-      neighbors.emplace_back(px, py + 1);
+  template <typename Grid> bool walkable(const Grid &grid, int x, int y) const {
+    return x >= 0 && y >= 0 && x < static_cast<int>(grid.getWidth()) &&
+           y < static_cast<int>(grid.getHeight()) && isNavigable(grid(x, y));
+  }
 
-    return neighbors;
+  // A diagonal step needs both cells it squeezes past to be open.
+  template <typename Grid>
+  bool canStep(const Grid &grid, int x, int y, int dx, int dy) const {
+    return walkable(grid, x + dx, y + dy) &&
+           (dx == 0 || dy == 0 ||
+            (walkable(grid, x + dx, y) && walkable(grid, x, y + dy)));
+  }
+
+  // Scans from (x, y) in direction (dx, dy) for the next jump point: the
+  // goal, or a cell where an optimal route might turn. Returns false when
+  // the scan runs into a wall first.
+  template <typename Grid>
+  bool jump(const Grid &grid, const Point &end, int x, int y, int dx, int dy,
+            Point &found) const {
+    Point ignored;
+    while (canStep(grid, x, y, dx, dy)) {
+      x += dx;
+      y += dy;
+      bool isJumpPoint = x == end.x && y == end.y;
+      if (dx != 0 && dy != 0) {
+        isJumpPoint = isJumpPoint ||
+                      jump(grid, end, x, y, dx, 0, ignored) ||
+                      jump(grid, end, x, y, 0, dy, ignored);
+      } else if (dx != 0) {
+        isJumpPoint = isJumpPoint ||
+                      (walkable(grid, x, y - 1) &&
+                       !walkable(grid, x - dx, y - 1)) ||
+                      (walkable(grid, x, y + 1) &&
+                       !walkable(grid, x - dx, y + 1));
+      } else {
+        isJumpPoint = isJumpPoint ||
+                      (walkable(grid, x - 1, y) &&
+                       !walkable(grid, x - 1, y - dy)) ||
+                      (walkable(grid, x + 1, y) &&
+                       !walkable(grid, x + 1, y - dy));
+        // Without diagonals a turn off a vertical run is only seen by
+        // looking sideways from every cell of it
+        if (!eightWay) {
+          isJumpPoint = isJumpPoint ||
+                        jump(grid, end, x, y, 1, 0, ignored) ||
+                        jump(grid, end, x, y, -1, 0, ignored);
+        }
+      }
+      if (isJumpPoint) {
+        found = Point(x, y);
+        return true;
+      }
+    }
+    return false;
   }
 
-  static int heuristic(const Point &a, const Point &b) {
-    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+  template <typename Grid>
+  void solveJumpPoint(const Grid &grid, const Point &start, const Point &end,
+                      AStarWorkspace &workspace) {
+    const int width = static_cast<int>(grid.getWidth());
+    const int height = static_cast<int>(grid.getHeight());
+    auto estimate = [&end](int x, int y) {
+      return eightWay ? octileHeuristic(x, y, end) : heuristic(x, y, end);
+    };
+
+    workspace.prepare(static_cast<std::size_t>(width) * height);
+    const int startIndex = start.y * width + start.x;
+    const int endIndex = end.y * width + end.x;
+    workspace.open(startIndex, 0, startIndex, estimate(start.x, start.y));
+
+    for (std::size_t f = 0; f < workspace.buckets.size(); ++f) {
+      while (!workspace.buckets[f].empty()) {
+        const int current = workspace.buckets[f].back();
+        workspace.buckets[f].pop_back();
+        if (workspace.isClosed(current))
+          continue;
+        workspace.closedStamp[current] = workspace.generation;
+        ++expandedNodes;
+
+        if (current == endIndex) {
+          // Parents are whole jumps away; walk each straight or diagonal
+          // run back cell by cell
+          for (int node = endIndex; node != startIndex;) {
+            const int parent = workspace.cameFrom[node];
+            const Point to(node % width, node / width);
+            const Point from(parent % width, parent / width);
+            const Point step(sign(to.x - from.x), sign(to.y - from.y));
+            for (Point p = to; p != from; p = p - step) {
+              bestPath.push_front(p);
+            }
+            node = parent;
+          }
+          bestPath.push_front(start);
+          return;
+        }
+
+        const int cx = current % width;
+        const int cy = current / width;
+        const int parent = workspace.cameFrom[current];
+        const int px = sign(cx - parent % width);
+        const int py = sign(cy - parent / width);
+
+        // Only directions an optimal route through here could take; the
+        // jump scans themselves reject blocked ones
+        Point directions[8];
+        int directionCount = 0;
+        auto consider = [&](int dx, int dy) {
+          directions[directionCount++] = Point(dx, dy);
+        };
+        if (px == 0 && py == 0) {
+          consider(1, 0);
+          consider(-1, 0);
+          consider(0, 1);
+          consider(0, -1);
+          if (eightWay) {
+            consider(1, 1);
+            consider(1, -1);
+            consider(-1, 1);
+            consider(-1, -1);
+          }
+        } else if (px != 0 && py != 0) {
+          consider(px, 0);
+          consider(0, py);
+          consider(px, py);
+        } else if (px != 0) {
+          consider(px, 0);
+          consider(0, 1);
+          consider(0, -1);
+          if (eightWay) {
+            consider(px, 1);
+            consider(px, -1);
+          }
+        } else {
+          consider(0, py);
+          consider(1, 0);
+          consider(-1, 0);
+          if (eightWay) {
+            consider(1, py);
+            consider(-1, py);
+          }
+        }
+
+        for (int i = 0; i < directionCount; ++i) {
+          const Point &direction = directions[i];
+          Point found;
+          if (!jump(grid, end, cx, cy, direction.x, direction.y,
+                    found))
+            continue;
+          const int next = found.y * width + found.x;
+          if (workspace.isClosed(next))
+            continue;
+          const int steps = std::max(std::abs(found.x - cx),
+                                     std::abs(found.y - cy));
+          const int stepCost = !eightWay ? 1
+                               : (direction.x != 0 && direction.y != 0)
+                                   ? diagonalCost
+                                   : straightCost;
+          const int nextCost =
+              workspace.costFromStart[current] + steps * stepCost;
+          if (workspace.isOpened(next) &&
+              workspace.costFromStart[next] <= nextCost)
+            continue;
+          workspace.open(next, nextCost, current,
+                         nextCost + estimate(found.x, found.y));
+        }
+      }
+    }
   }
 
 public:
+  template <typename Grid>
   AStar(
-      const std::vector<std::vector<T>> &grid, Point start, Point end,
+      const Grid &grid, Point start, Point end,
       std::function<bool(T)> isNavigableFunc =
-          [](T value) { return static_cast<bool>(value); })
+          [](T value) { return static_cast<bool>(value); },
+      AStarMode mode = AStarMode::Classic)
       : isNavigable(std::move(isNavigableFunc)) {
-    solve(grid, std::move(start), std::move(end));
+    AStarWorkspace workspace;
+    solve(grid, start, end, workspace, mode);
   }
 
-  void solve(const std::vector<std::vector<T>> &grid, Point start, Point end) {
-    std::unordered_map<Point, Node> nodes;
-    std::unordered_set<Point> visited;
-    std::priority_queue<Point, std::vector<Point>,
-                        std::function<bool(Point, Point)>>
-        queue([&nodes](Point a, Point b) {
-          return nodes[a].totalEstimatedCost > nodes[b].totalEstimatedCost;
-        });
-
-    nodes[start] = Node(start, {}, 0, heuristic(start, end));
-    queue.push(start);
+  // Runs the search in a caller-owned workspace.
+  template <typename Grid>
+  AStar(
+      AStarWorkspace &workspace, const Grid &grid, Point start, Point end,
+      std::function<bool(T)> isNavigableFunc =
+          [](T value) { return static_cast<bool>(value); },
+      AStarMode mode = AStarMode::Classic)
+      : isNavigable(std::move(isNavigableFunc)) {
+    solve(grid, start, end, workspace, mode);
+  }
 
-    while (!queue.empty()) {
-      Point current = queue.top();
-      queue.pop();
+  AStar(
+      const std::vector<std::vector<T>> &grid, Point start, Point end,
+      std::function<bool(T)> isNavigableFunc =
+          [](T value) { return static_cast<bool>(value); },
+      AStarMode mode = AStarMode::Classic)
+      : isNavigable(std::move(isNavigableFunc)) {
+    const std::vector<T> cells = flatten(grid);
+    const unsigned int width = grid.empty() ? 0 : grid[0].size();
+    AStarWorkspace workspace;
+    solve(GridView<const T>(cells.data(), width, grid.size(), width), start,
+          end, workspace, mode);
+  }
 
-      // If the node was already visited, we ignore it
-      if (visited.count(current))
-        continue;
+  template <typename Grid>
+  void solve(const Grid &grid, const Point &start, const Point &end,
+             AStarWorkspace &workspace, AStarMode mode = AStarMode::Classic) {
+    const int width = static_cast<int>(grid.getWidth());
+    const int height = static_cast<int>(grid.getHeight());
+    auto contains = [width, height](const Point &p) {
+      return p.x >= 0 && p.y >= 0 && p.x < width && p.y < height;
+    };
+    bestPath.clear();
+    expandedNodes = 0;
+    if (!contains(start) || !contains(end))
+      return;
+    if (mode != AStarMode::Classic) {
+      solveJumpPoint(grid, start, end, workspace);
+      return;
+    }
+    auto estimate = [&end](int x, int y) {
+      return eightWay ? octileHeuristic(x, y, end) : heuristic(x, y, end);
+    };
 
-      visited.insert(current);
+    workspace.prepare(static_cast<std::size_t>(width) * height);
+    const int startIndex = start.y * width + start.x;
+    const int endIndex = end.y * width + end.x;
+    workspace.open(startIndex, 0, startIndex, estimate(start.x, start.y));
 
-      if (current == end) {
-        while (current != start) {
-          bestPath.push_front(current);
-          current = nodes[current].cameFrom;
-        }
+    // Buckets are re-indexed on every pass because open() may grow them
+    for (std::size_t f = 0; f < workspace.buckets.size(); ++f) {
+      while (!workspace.buckets[f].empty()) {
+        const int current = workspace.buckets[f].back();
+        workspace.buckets[f].pop_back();
 
-        bestPath.push_front(start);
-        return;
-      }
+        // Stale entry for a node already expanded through a cheaper route
+        if (workspace.isClosed(current))
+          continue;
+        workspace.closedStamp[current] = workspace.generation;
+        ++expandedNodes;
 
-      for (const auto &neighbor : getNeighbors(current, grid)) {
-        if (visited.count(neighbor))
-          continue; // Ignore if neighbor was already visited
+        if (current == endIndex) {
+          for (int step = endIndex; step != startIndex;
+               step = workspace.cameFrom[step]) {
+            bestPath.emplace_front(step % width, step / width);
+          }
+          bestPath.push_front(start);
+          return;
+        }
 
-        int tentativeCostFromStart =
-            nodes[current].costFromStart + 1; // Assuming all moves cost 1
+        const int cx = current % width;
+        const int cy = current / width;
+        auto relax = [&](int nx, int ny, int stepCost) {
+          const int next = ny * width + nx;
+          const int nextCost = workspace.costFromStart[current] + stepCost;
+          if (workspace.isClosed(next) ||
+              (workspace.isOpened(next) &&
+               workspace.costFromStart[next] <= nextCost))
+            return;
+          if (!isNavigable(grid(nx, ny)))
+            return;
+          workspace.open(next, nextCost, current,
+                         nextCost + estimate(nx, ny));
+        };
 
-        if (!nodes.count(neighbor) ||
-            tentativeCostFromStart < nodes[neighbor].costFromStart) {
-          nodes[neighbor] =
-              Node(neighbor, current, tentativeCostFromStart,
-                   tentativeCostFromStart + heuristic(neighbor, end));
-          queue.push(neighbor);
+        if constexpr (eightWay) {
+          for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+              if ((dx != 0 || dy != 0) && canStep(grid, cx, cy, dx, dy))
+                relax(cx + dx, cy + dy,
+                      dx != 0 && dy != 0 ? diagonalCost : straightCost);
+            }
+          }
+        } else {
+          if (cx > 0)
+            relax(cx - 1, cy, 1);
+          if (cx < width - 1)
+            relax(cx + 1, cy, 1);
+          if (cy > 0)
+            relax(cx, cy - 1, 1);
+          if (cy < height - 1)
+            relax(cx, cy + 1, 1);
         }
       }
     }
   }
 
   [[nodiscard]] auto getPath() const -> std::deque<Point> { return bestPath; }
+
+  // Nodes taken off the open list by the last search.
+  std::size_t getExpandedNodes() const { return expandedNodes; }
 };
 
 #endif // A_STAR_H
@@ -0,0 +1,123 @@
+#include "articulation_points.h"
+#include "utils/chunked_grid.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace {
+constexpr std::array<std::pair<int, int>, 4> directions = {
+    std::pair<int, int>{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+// DFS frame: the cell and the next direction to try from it.
+struct Frame {
+  int cell;
+  int direction;
+};
+
+// Per-cell DFS state. discovery == 0 marks unvisited cells.
+struct Visit {
+  int discovery = 0;
+  int low = 0;
+  int parent = -1;
+
+  bool operator==(const Visit &other) const {
+    return discovery == other.discovery && low == other.low &&
+           parent == other.parent;
+  }
+};
+} // namespace
+
+void ArticulationPoints::build(const BitGrid &cells, const Point &from,
+                               const Point &to) {
+  const int width = static_cast<int>(cells.getWidth());
+  const int height = static_cast<int>(cells.getHeight());
+  cut.reset(width, height);
+  separating.reset(width, height);
+  targetReached = false;
+  if (!cells.test(from.x, from.y)) {
+    return;
+  }
+
+  // Only chunks the DFS enters get state of their own, so the scratch
+  // follows from's component rather than the map
+  ChunkedGrid<Visit, 6> visits(width, height, Visit());
+  auto visit = [&visits, width](int cell) -> Visit {
+    return visits.get(cell % width, cell / width);
+  };
+  auto update = [&visits, width](int cell, const Visit &state) {
+    visits.set(cell % width, cell / width, state);
+  };
+  std::vector<Frame> stack;
+  int time = 0;
+  int rootChildren = 0;
+
+  const int root = from.y * width + from.x;
+  ++time;
+  update(root, {time, time, -1});
+  stack.push_back({root, 0});
+  while (!stack.empty()) {
+    Frame &frame = stack.back();
+    const int cell = frame.cell;
+    if (frame.direction < static_cast<int>(directions.size())) {
+      const auto [dx, dy] = directions[frame.direction++];
+      const int nx = cell % width + dx;
+      const int ny = cell / width + dy;
+      if (!cells.test(nx, ny)) {
+        continue;
+      }
+      const int next = ny * width + nx;
+      const Visit nextState = visit(next);
+      if (nextState.discovery == 0) {
+        ++time;
+        update(next, {time, time, cell});
+        stack.push_back({next, 0}); // `frame` is invalid from here on
+      } else {
+        Visit state = visit(cell);
+        if (next != state.parent &&
+            nextState.discovery < state.low) {
+          state.low = nextState.discovery;
+          update(cell, state);
+        }
+      }
+      continue;
+    }
+
+    // All neighbours done: report back to the parent
+    stack.pop_back();
+    const Visit state = visit(cell);
+    const int above = state.parent;
+    if (above < 0) {
+      continue;
+    }
+    Visit aboveState = visit(above);
+    if (state.low < aboveState.low) {
+      aboveState.low = state.low;
+      update(above, aboveState);
+    }
+    if (above == root) {
+      ++rootChildren;
+    } else if (state.low >= aboveState.discovery) {
+      cut.set(above % width, above / width, true);
+    }
+  }
+  if (rootChildren > 1) {
+    cut.set(from.x, from.y, true);
+  }
+
+  if (!cells.test(to.x, to.y) || visit(to.y * width + to.x).discovery == 0) {
+    return;
+  }
+  targetReached = true;
+  // A cell separates the ends iff it is an ancestor of `to` whose child on
+  // the way down cannot climb above it
+  for (int child = to.y * width + to.x, cell = visit(child).parent;
+       cell != root; child = cell, cell = visit(cell).parent) {
+    if (cell < 0) {
+      break; // `to` is the root itself
+    }
+    if (visit(child).low >= visit(cell).discovery) {
+      separating.set(cell % width, cell / width, true);
+    }
+  }
+}
@@ -0,0 +1,35 @@
+#ifndef ARTICULATION_POINTS_H
+#define ARTICULATION_POINTS_H
+
+#include "utils/bit_grid.h"
+#include "utils/point.h"
+
+// Articulation points of the 4-connected graph of set cells in a BitGrid:
+// cells whose removal splits their component. Found once per build() by an
+// iterative Tarjan DFS (no recursion, so corridor-heavy levels cannot blow
+// the stack), after which every query is a single bit test. The DFS keeps
+// its per-cell state in 64x64 chunks allocated as it enters them, so a
+// build costs memory for the component searched, not the whole grid.
+//
+// The DFS is rooted at `from`, so only its component is classified. Cells
+// on every route from `from` to `to` are recorded separately: a blocker on
+// any other cell leaves a way around.
+class ArticulationPoints {
+public:
+  void build(const BitGrid &cells, const Point &from, const Point &to);
+
+  // Removing `cell` disconnects part of from's component from the rest.
+  bool isCut(const Point &cell) const { return cut.test(cell.x, cell.y); }
+  // Every route from `from` to `to` passes `cell` (neither end counts).
+  bool separates(const Point &cell) const {
+    return separating.test(cell.x, cell.y);
+  }
+  bool reachesTarget() const { return targetReached; }
+
+private:
+  BitGrid cut;
+  BitGrid separating;
+  bool targetReached = false;
+};
+
+#endif // ARTICULATION_POINTS_H
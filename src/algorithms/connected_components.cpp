@@ -0,0 +1,93 @@
+#include "connected_components.h"
+#include <array>
+#include <utility>
+
+namespace {
+constexpr std::array<std::pair<int, int>, 4> directions = {
+    std::pair<int, int>{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+} // namespace
+
+void ConnectedComponents::build(const BitGrid &cells) {
+  width = static_cast<int>(cells.getWidth());
+  height = static_cast<int>(cells.getHeight());
+  labels.reset(width, height, -1);
+  parent.clear();
+  components = 0;
+
+  for (int y = 0; y < height; ++y) {
+    const BitGrid::Word *row = cells.row(y);
+    for (unsigned int index = 0; index < cells.getWordsPerRow(); ++index) {
+      // Whole words of wall are skipped without touching the labels
+      BitGrid::forEachSetBit(index * BitGrid::wordBits, row[index],
+                             [&](int x) { flood(cells, x, y); });
+    }
+  }
+}
+
+void ConnectedComponents::flood(const BitGrid &cells, int x, int y) {
+  if (labels.get(x, y) >= 0) {
+    return;
+  }
+  const int label = static_cast<int>(parent.size());
+  parent.push_back(label);
+  ++components;
+
+  frontier.clear();
+  frontier.emplace_back(x, y);
+  labels.set(x, y, label);
+  for (std::size_t head = 0; head < frontier.size(); ++head) {
+    const Point current = frontier[head];
+    for (const auto &[dx, dy] : directions) {
+      const int nx = current.x + dx;
+      const int ny = current.y + dy;
+      if (cells.test(nx, ny) && labels.get(nx, ny) < 0) {
+        labels.set(nx, ny, label);
+        frontier.emplace_back(nx, ny);
+      }
+    }
+  }
+}
+
+void ConnectedComponents::add(const BitGrid &cells, const Point &cell) {
+  if (labelAt(cell) >= 0 || !cells.test(cell.x, cell.y)) {
+    return;
+  }
+  int root = -1;
+  for (const auto &[dx, dy] : directions) {
+    const Point next(cell.x + dx, cell.y + dy);
+    const int label = labelAt(next);
+    if (label < 0 || !cells.test(next.x, next.y)) {
+      continue;
+    }
+    const int other = find(label);
+    if (root < 0) {
+      root = other;
+    } else if (other != root) {
+      parent[other] = root; // Two components meet here
+      --components;
+    }
+  }
+  if (root < 0) {
+    root = static_cast<int>(parent.size());
+    parent.push_back(root);
+    ++components;
+  }
+  labels.set(cell.x, cell.y, root);
+}
+
+bool ConnectedComponents::connected(const Point &a, const Point &b) {
+  const int labelA = labelAt(a);
+  const int labelB = labelAt(b);
+  if (labelA < 0 || labelB < 0) {
+    return false;
+  }
+  return find(labelA) == find(labelB);
+}
+
+int ConnectedComponents::find(int label) {
+  while (parent[label] != label) {
+    parent[label] = parent[parent[label]]; // Path halving
+    label = parent[label];
+  }
+  return label;
+}
@@ -0,0 +1,56 @@
+#ifndef CONNECTED_COMPONENTS_H
+#define CONNECTED_COMPONENTS_H
+
+#include "utils/bit_grid.h"
+#include "utils/chunked_grid.h"
+#include "utils/point.h"
+#include <cstddef>
+#include <vector>
+
+// Labels the 4-connected components of the set cells of a BitGrid, so
+// "can A reach B at all?" costs two label lookups. Cells that become set
+// later are merged in through union-find over the labels. A cell that
+// becomes unset may split its component, which union-find cannot undo;
+// callers rebuild after such writes. Labels live in 64x64 chunks, so
+// chunks without a set cell share one unlabelled chunk and memory follows
+// the carved area rather than the bounding box.
+class ConnectedComponents {
+public:
+  // Labels every set cell of `cells`. O(width * height / 64 + set cells).
+  void build(const BitGrid &cells);
+
+  // `cell` has just been set in `cells`, the grid last given to build()
+  // with every add() since applied. Joins it to its neighbours' components.
+  void add(const BitGrid &cells, const Point &cell);
+
+  // Both cells are set and in the same component. Not const: lookups
+  // shorten union-find chains as they go.
+  bool connected(const Point &a, const Point &b);
+
+  std::size_t componentCount() const { return components; }
+  std::size_t memoryUsage() const {
+    return labels.memoryUsage() + parent.capacity() * sizeof(int);
+  }
+
+private:
+  int width = 0;
+  int height = 0;
+  // Per cell: its label, or -1 for unset cells
+  ChunkedGrid<int, 6> labels;
+  // Per label: union-find parent; roots name the components
+  std::vector<int> parent;
+  std::vector<Point> frontier; // Flood-fill queue, kept between builds
+  std::size_t components = 0;
+
+  int labelAt(const Point &p) const {
+    if (p.x < 0 || p.y < 0 || p.x >= width || p.y >= height) {
+      return -1;
+    }
+    return labels.get(p.x, p.y);
+  }
+  // Labels the component of the set cell (x, y), unless already labelled.
+  void flood(const BitGrid &cells, int x, int y);
+  int find(int label);
+};
+
+#endif // CONNECTED_COMPONENTS_H
@@ -0,0 +1,8 @@
+#ifndef CONNECTIVITY_H
+#define CONNECTIVITY_H
+
+// Which neighbours a grid search steps to: the four sharing an edge with a
+// cell, or all eight around it.
+enum class Connectivity { Four, Eight };
+
+#endif // CONNECTIVITY_H
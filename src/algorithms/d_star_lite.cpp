@@ -0,0 +1,294 @@
+#include "d_star_lite.h"
+#include <algorithm>
+#include <array>
+
+namespace {
+constexpr std::array<std::pair<int, int>, 4> directions = {
+    std::pair<int, int>{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+} // namespace
+
+void DStarLite::reset(const BitGrid &navigableCells) {
+  navigable = navigableCells;
+  origin = Point(0, 0);
+  startOver();
+}
+
+void DStarLite::reset(const BitGrid &navigableCells, const Point &centre,
+                      int radius) {
+  const int left = std::max(centre.x - radius, 0);
+  const int top = std::max(centre.y - radius, 0);
+  const int right = std::min<int>(centre.x + radius + 1,
+                                  navigableCells.getWidth());
+  const int bottom = std::min<int>(centre.y + radius + 1,
+                                   navigableCells.getHeight());
+  origin = Point(left, top);
+  navigable.reset(std::max(right - left, 0), std::max(bottom - top, 0));
+  for (int y = top; y < bottom; ++y) {
+    for (int x = left; x < right; ++x) {
+      navigable.set(x - left, y - top, navigableCells.test(x, y));
+    }
+  }
+  startOver();
+}
+
+void DStarLite::startOver() {
+  width = static_cast<int>(navigable.getWidth());
+  height = static_cast<int>(navigable.getHeight());
+  const std::size_t area = static_cast<std::size_t>(width) * height;
+  stamps.assign(area, 0);
+  g.resize(area);
+  rhs.resize(area);
+  queuedKey.resize(area);
+  queued.assign(area, false);
+  generation = 0;
+  open = {};
+  anchor = Point(-1, -1);
+  lastStart = Point(-1, -1);
+  km = 0;
+  trail.clear();
+  trailBroken = false;
+}
+
+void DStarLite::setNavigable(int x, int y, bool isNavigable) {
+  x -= origin.x;
+  y -= origin.y;
+  if (!navigable.contains(x, y) || navigable.test(x, y) == isNavigable) {
+    return;
+  }
+  navigable.set(x, y, isNavigable);
+  if (anchor.x < 0) {
+    return; // Nothing searched yet
+  }
+  const Point changed(x, y);
+  if (!isNavigable &&
+      (changed == anchor ||
+       std::find(trail.begin(), trail.end(), changed) != trail.end())) {
+    trailBroken = true;
+    return; // The next plan() starts over anyway
+  }
+
+  // Only edges into the changed cell changed, so only its neighbours'
+  // rhs can move; a reopened cell also needs its own rhs worked out
+  const int cell = cellOf(changed);
+  int neighbours[4];
+  const int count = navigableNeighbours(cell, neighbours);
+  for (int i = 0; i < count; ++i) {
+    updateVertex(neighbours[i]);
+  }
+  if (isNavigable) {
+    updateVertex(cell);
+  }
+}
+
+std::deque<Point> DStarLite::plan(const Point &from, const Point &to) {
+  expandedNodes = 0;
+  std::deque<Point> path;
+  // Searched in window cells, handed back in grid cells
+  const Point start = from - origin;
+  const Point goal = to - origin;
+  auto toGrid = [this, &path]() {
+    for (Point &p : path) {
+      p += origin;
+    }
+  };
+  if (!isReady() || !navigable.contains(start.x, start.y) ||
+      !navigable.contains(goal.x, goal.y) ||
+      !navigable.test(start.x, start.y) || !navigable.test(goal.x, goal.y)) {
+    return path;
+  }
+  if (start == goal) {
+    path.push_back(from);
+    return path;
+  }
+
+  const bool fresh = anchor.x < 0 || trailBroken || !followGoal(goal);
+  if (fresh) {
+    reroot(start, goal);
+  } else if (start != lastStart) {
+    km += heuristic(lastStart, start);
+    lastStart = start;
+  }
+  computeShortestPath();
+
+  const int startCell = cellOf(start);
+  if (!fresh &&
+      trail.size() > std::max<std::size_t>(minTrail, g[startCell] / 4)) {
+    reroot(start, goal);
+    computeShortestPath();
+  }
+  if (g[startCell] >= infinity) {
+    return path;
+  }
+
+  // Walk down g to the anchor, then along the trail to the goal, leaving
+  // out the detour if the walk already crosses the trail
+  const int anchorCell = cellOf(anchor);
+  const std::size_t area = stamps.size();
+  path.push_back(start);
+  int current = startCell;
+  auto joinsTrail = [this, &path](const Point &p) {
+    auto onTrail = std::find(trail.begin(), trail.end(), p);
+    if (onTrail == trail.end()) {
+      return false;
+    }
+    path.insert(path.end(), onTrail + 1, trail.end());
+    return true;
+  };
+  while (current != anchorCell) {
+    int neighbours[4];
+    const int count = navigableNeighbours(current, neighbours);
+    int best = -1;
+    for (int i = 0; i < count; ++i) {
+      touch(neighbours[i]);
+      if (best < 0 || g[neighbours[i]] < g[best]) {
+        best = neighbours[i];
+      }
+    }
+    if (best < 0 || g[best] >= infinity || path.size() > area) {
+      path.clear();
+      return path;
+    }
+    current = best;
+    path.emplace_back(current % width, current / width);
+    if (joinsTrail(path.back())) {
+      toGrid();
+      return path;
+    }
+  }
+  path.insert(path.end(), trail.begin(), trail.end());
+  toGrid();
+  return path;
+}
+
+int DStarLite::navigableNeighbours(int cell, int out[4]) const {
+  const int x = cell % width;
+  const int y = cell / width;
+  int count = 0;
+  for (const auto &[dx, dy] : directions) {
+    if (navigable.test(x + dx, y + dy)) {
+      out[count++] = (y + dy) * width + x + dx;
+    }
+  }
+  return count;
+}
+
+void DStarLite::touch(int cell) {
+  if (stamps[cell] != generation) {
+    stamps[cell] = generation;
+    g[cell] = infinity;
+    rhs[cell] = infinity;
+    queued[cell] = false;
+  }
+}
+
+DStarLite::Key DStarLite::calculateKey(int cell) {
+  touch(cell);
+  const int best = std::min(g[cell], rhs[cell]);
+  const Point p(cell % width, cell / width);
+  return {best + heuristic(lastStart, p) + km, best};
+}
+
+void DStarLite::push(int cell) {
+  const Key key = calculateKey(cell);
+  queuedKey[cell] = key;
+  queued[cell] = true;
+  open.push({key, cell});
+}
+
+void DStarLite::updateVertex(int cell) {
+  touch(cell);
+  if (cell != cellOf(anchor)) {
+    int neighbours[4];
+    const int count = navigableNeighbours(cell, neighbours);
+    int best = infinity;
+    for (int i = 0; i < count; ++i) {
+      touch(neighbours[i]);
+      best = std::min(best, g[neighbours[i]] + 1);
+    }
+    rhs[cell] = std::min(best, infinity);
+  }
+  queued[cell] = false; // Any entry left in the heap is now stale
+  if (g[cell] != rhs[cell]) {
+    push(cell);
+  }
+}
+
+bool DStarLite::peek(Entry &top) {
+  while (!open.empty()) {
+    const Entry &entry = open.top();
+    if (stamps[entry.cell] == generation && queued[entry.cell] &&
+        queuedKey[entry.cell] == entry.key) {
+      top = entry;
+      return true;
+    }
+    open.pop();
+  }
+  return false;
+}
+
+void DStarLite::computeShortestPath() {
+  const int startCell = cellOf(lastStart);
+  Entry top;
+  while (peek(top)) {
+    if (!(top.key < calculateKey(startCell)) &&
+        rhs[startCell] == g[startCell]) {
+      break;
+    }
+    open.pop();
+    const int cell = top.cell;
+    queued[cell] = false;
+    ++expandedNodes;
+
+    const Key fresh = calculateKey(cell);
+    if (top.key < fresh) {
+      push(cell); // km grew since it was queued
+      continue;
+    }
+    int neighbours[4];
+    const int count = navigableNeighbours(cell, neighbours);
+    if (g[cell] > rhs[cell]) {
+      g[cell] = rhs[cell];
+    } else {
+      g[cell] = infinity;
+      updateVertex(cell);
+    }
+    for (int i = 0; i < count; ++i) {
+      updateVertex(neighbours[i]);
+    }
+  }
+}
+
+void DStarLite::reroot(const Point &start, const Point &goal) {
+  if (++generation == 0) {
+    std::fill(stamps.begin(), stamps.end(), 0);
+    generation = 1;
+  }
+  open = {};
+  km = 0;
+  anchor = goal;
+  lastStart = start;
+  trail.clear();
+  trailBroken = false;
+  const int anchorCell = cellOf(anchor);
+  touch(anchorCell);
+  rhs[anchorCell] = 0;
+  push(anchorCell);
+}
+
+bool DStarLite::followGoal(const Point &goal) {
+  if (goal == anchor) {
+    trail.clear();
+    return true;
+  }
+  auto onTrail = std::find(trail.begin(), trail.end(), goal);
+  if (onTrail != trail.end()) {
+    trail.erase(onTrail + 1, trail.end());
+    return true;
+  }
+  const Point &tip = trail.empty() ? anchor : trail.back();
+  if (heuristic(tip, goal) != 1) {
+    return false;
+  }
+  trail.push_back(goal);
+  return true;
+}
@@ -0,0 +1,106 @@
+#ifndef D_STAR_LITE_H
+#define D_STAR_LITE_H
+
+#include "utils/bit_grid.h"
+#include "utils/point.h"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// Incremental 4-connected planner for one long-lived pursuit (D* Lite).
+// The search grows from an anchor on the goal side toward the pursuer, so
+// a pursuer moving along its path only shifts the heuristic (km), and a
+// cell changing only reopens the cells whose distance depends on it.
+//
+// A goal that walks away is followed by a trail of its steps from the
+// anchor instead of a new search; stepping back onto the trail shortens it.
+// Once the trail grows past a quarter of the remaining distance, or the
+// goal jumps, the anchor moves to the goal and the search starts over.
+//
+// The planner may be confined to a window of the grid, so its memory
+// follows the window rather than the level; cells outside it are
+// treated as blocked.
+class DStarLite {
+public:
+  // Starts over on new terrain; the next plan() searches from scratch.
+  void reset(const BitGrid &navigableCells);
+  // Same, keeping only the cells within `radius` steps of `centre` on
+  // either axis.
+  void reset(const BitGrid &navigableCells, const Point &centre, int radius);
+  bool isReady() const { return width > 0; }
+  // The point lies inside the window the planner was last reset to.
+  bool covers(const Point &point) const {
+    return isReady() && navigable.contains(point.x - origin.x,
+                                           point.y - origin.y);
+  }
+
+  // Repairs the search for one cell that became (non-)navigable.
+  void setNavigable(int x, int y, bool isNavigable);
+
+  // Path from start to goal, both included; empty if there is none.
+  std::deque<Point> plan(const Point &start, const Point &goal);
+
+  // Cells taken off the open list by the last plan().
+  std::size_t getExpandedNodes() const { return expandedNodes; }
+
+private:
+  using Key = std::pair<int, int>;
+  struct Entry {
+    Key key;
+    int cell;
+    bool operator>(const Entry &other) const { return key > other.key; }
+  };
+
+  static constexpr int infinity = INT_MAX / 4;
+  static constexpr std::size_t minTrail = 8;
+
+  BitGrid navigable; // The window, from `origin` on
+  Point origin{0, 0};
+  int width = 0;
+  int height = 0;
+
+  // Per-cell state, valid when stamped with the current generation
+  std::uint32_t generation = 0;
+  std::vector<std::uint32_t> stamps;
+  std::vector<int> g;
+  std::vector<int> rhs;
+  std::vector<Key> queuedKey;
+  std::vector<bool> queued;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+  Point anchor{-1, -1};
+  Point lastStart{-1, -1};
+  int km = 0;
+  std::vector<Point> trail; // Goal steps taken since the anchor was set
+  bool trailBroken = false;
+  std::size_t expandedNodes = 0;
+
+  // Sizes the per-cell state to the window and forgets the last search.
+  void startOver();
+  int cellOf(const Point &p) const { return p.y * width + p.x; }
+  static int heuristic(const Point &a, const Point &b) {
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+  }
+
+  // Navigable cells next to `cell`, written to `out`; returns their count.
+  int navigableNeighbours(int cell, int out[4]) const;
+  void touch(int cell);
+  Key calculateKey(int cell);
+  void push(int cell);
+  void updateVertex(int cell);
+  // Top of the open list after dropping stale entries; false if empty.
+  bool peek(Entry &top);
+  void computeShortestPath();
+  void reroot(const Point &start, const Point &goal);
+  // Moves the end of the trail to `goal`; false if the trail cannot
+  // follow it there.
+  bool followGoal(const Point &goal);
+};
+
+#endif // D_STAR_LITE_H
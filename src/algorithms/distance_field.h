@@ -0,0 +1,158 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include "utils/point.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Breadth-first step counts from one source cell, 8-connected, out to a
+// fixed radius. Computed once and read by any number of walkers: each one
+// steps to its closest neighbour and so follows a shortest route around
+// walls, with no search of its own. Buffers are kept between computes and
+// cells are stamped per compute, so refreshing costs O(reached cells).
+// Steps are 8-connected, so every reached cell lies within maxDistance of
+// the source on both axes: the buffers cover that (2 * maxDistance + 1)^2
+// window only, whatever the size of the grid.
+class DistanceField {
+public:
+  static constexpr int unreached = -1;
+
+  // Recomputes the field around `source`. Cells further than maxDistance
+  // steps, or only reachable through cells where isPassable(x, y) is
+  // false, stay unreached.
+  template <typename Passable>
+  void compute(unsigned int fieldWidth, unsigned int fieldHeight,
+               const Point &fieldSource, int fieldMaxDistance,
+               Passable isPassable) {
+    width = static_cast<int>(fieldWidth);
+    height = static_cast<int>(fieldHeight);
+    source = fieldSource;
+    maxDistance = std::max(fieldMaxDistance, 0);
+    side = 2 * maxDistance + 1;
+    origin = Point(source.x - maxDistance, source.y - maxDistance);
+    frontier.clear();
+    nextGeneration();
+    if (!contains(source.x, source.y)) {
+      return;
+    }
+
+    const std::size_t area = static_cast<std::size_t>(side) * side;
+    if (area > stamps.size()) {
+      stamps.assign(area, 0);
+      distances.resize(area);
+    }
+
+    reach(indexOf(source.x, source.y), 0);
+    for (std::size_t head = 0; head < frontier.size(); ++head) {
+      const int current = frontier[head];
+      const int nextDistance = distances[current] + 1;
+      if (nextDistance > maxDistance) {
+        continue;
+      }
+      const int cx = origin.x + current % side;
+      const int cy = origin.y + current / side;
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          const int nx = cx + dx;
+          const int ny = cy + dy;
+          if (!contains(nx, ny)) {
+            continue;
+          }
+          const int next = indexOf(nx, ny);
+          if (stamps[next] == generation || !isPassable(nx, ny)) {
+            continue;
+          }
+          reach(next, nextDistance);
+        }
+      }
+    }
+  }
+
+  // Forgets the last compute; every cell reads as unreached.
+  void clear() {
+    source = Point(-1, -1);
+    frontier.clear();
+    nextGeneration();
+  }
+
+  const Point &getSource() const { return source; }
+  int getMaxDistance() const { return maxDistance; }
+  // Number of cells the last compute reached, the source included.
+  std::size_t reachedCount() const { return frontier.size(); }
+  std::size_t memoryUsage() const {
+    return stamps.capacity() * sizeof(std::uint32_t) +
+           (distances.capacity() + frontier.capacity()) * sizeof(int);
+  }
+
+  int distanceAt(const Point &point) const {
+    if (!contains(point.x, point.y)) {
+      return unreached;
+    }
+    const int index = indexOf(point.x, point.y);
+    return stamps[index] == generation ? distances[index] : unreached;
+  }
+
+  // Unit step toward the closest reached neighbour that is nearer the
+  // source, straight steps winning ties. (0, 0) at the source or when
+  // `from` is unreached.
+  Point descend(const Point &from) const {
+    static const Point steps[8] = {Point(1, 0),  Point(-1, 0), Point(0, 1),
+                                   Point(0, -1), Point(1, 1),  Point(-1, 1),
+                                   Point(1, -1), Point(-1, -1)};
+    int best = distanceAt(from);
+    Point bestStep(0, 0);
+    if (best == unreached) {
+      return bestStep;
+    }
+    for (const Point &step : steps) {
+      const int distance = distanceAt(from + step);
+      if (distance != unreached && distance < best) {
+        best = distance;
+        bestStep = step;
+      }
+    }
+    return bestStep;
+  }
+
+private:
+  int width = 0;
+  int height = 0;
+  Point source{-1, -1};
+  int maxDistance = 0;
+  // The window around the source: its top-left cell and side length.
+  Point origin{0, 0};
+  int side = 0;
+  std::uint32_t generation = 0;
+  // Per window cell
+  std::vector<std::uint32_t> stamps;
+  std::vector<int> distances;
+  // Reached window cells in BFS order, doubling as the queue.
+  std::vector<int> frontier;
+
+  // Inside both the grid and the window.
+  bool contains(int x, int y) const {
+    return x >= 0 && y >= 0 && x < width && y < height && x >= origin.x &&
+           y >= origin.y && x < origin.x + side && y < origin.y + side;
+  }
+  int indexOf(int x, int y) const {
+    return (y - origin.y) * side + (x - origin.x);
+  }
+
+  void nextGeneration() {
+    if (++generation == 0) {
+      // Stamps wrapped around; forget every old compute once
+      std::fill(stamps.begin(), stamps.end(), 0);
+      generation = 1;
+    }
+  }
+
+  void reach(int cell, int distance) {
+    stamps[cell] = generation;
+    distances[cell] = distance;
+    frontier.push_back(cell);
+  }
+};
+
+#endif // DISTANCE_FIELD_H
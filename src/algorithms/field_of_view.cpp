@@ -0,0 +1,132 @@
+#include "field_of_view.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+namespace {
+// Maps (depth, column) of each quadrant onto grid offsets: the depth axis
+// then the column axis. North, south, east, west.
+constexpr std::array<std::array<int, 4>, 4> quadrants = {{
+    {0, -1, 1, 0},
+    {0, 1, 1, 0},
+    {1, 0, 0, 1},
+    {-1, 0, 0, 1},
+}};
+
+int floorDivide(int numerator, int denominator) {
+  const int quotient = numerator / denominator;
+  return (numerator % denominator != 0 && (numerator < 0) != (denominator < 0))
+             ? quotient - 1
+             : quotient;
+}
+
+int ceilDivide(int numerator, int denominator) {
+  return -floorDivide(-numerator, denominator);
+}
+} // namespace
+
+bool FieldOfView::update(const BitGrid &opaque, const Point &viewer,
+                         int viewRadius) {
+  if (!stale && viewer == origin && viewRadius == radius &&
+      visible.getWidth() == opaque.getWidth() &&
+      visible.getHeight() == opaque.getHeight()) {
+    return false;
+  }
+  compute(opaque, viewer, viewRadius);
+  return true;
+}
+
+void FieldOfView::compute(const BitGrid &opaque, const Point &viewer,
+                          int viewRadius) {
+  if (visible.getWidth() != opaque.getWidth() ||
+      visible.getHeight() != opaque.getHeight()) {
+    visible.reset(opaque.getWidth(), opaque.getHeight());
+  } else if (radius >= 0) {
+    // Only the rows the last compute reached can hold visible cells
+    const int top = std::max(0, origin.y - radius);
+    const int bottom =
+        std::min(static_cast<int>(visible.getHeight()) - 1, origin.y + radius);
+    for (int y = top; y <= bottom; ++y) {
+      std::fill_n(visible.row(y), visible.getWordsPerRow(), BitGrid::Word(0));
+    }
+  }
+  origin = viewer;
+  radius = viewRadius;
+  stale = false;
+  if (!visible.contains(origin.x, origin.y) || radius < 0) {
+    return;
+  }
+  visible.set(origin.x, origin.y, true);
+
+  const int radiusSquared = radius * radius;
+  for (const auto &[depthX, depthY, columnX, columnY] : quadrants) {
+    auto cellAt = [&, depthX = depthX, depthY = depthY, columnX = columnX,
+                   columnY = columnY](int depth, int column) {
+      return Point(origin.x + depth * depthX + column * columnX,
+                   origin.y + depth * depthY + column * columnY);
+    };
+
+    rows.clear();
+    rows.push_back({1, -1, 1, 1, 1});
+    while (!rows.empty()) {
+      Row row = rows.back();
+      rows.pop_back();
+      if (row.depth > radius) {
+        continue;
+      }
+      // Columns whose centre lies within the slopes, ties rounded outward
+      const int firstColumn = floorDivide(
+          2 * row.depth * row.startNumerator + row.startDenominator,
+          2 * row.startDenominator);
+      const int lastColumn = ceilDivide(
+          2 * row.depth * row.endNumerator - row.endDenominator,
+          2 * row.endDenominator);
+
+      bool previousWall = false;
+      bool previousSet = false;
+      for (int column = firstColumn; column <= lastColumn; ++column) {
+        const Point cell = cellAt(row.depth, column);
+        const bool wall = !opaque.contains(cell.x, cell.y) ||
+                          opaque.test(cell.x, cell.y);
+        // Walls light up as soon as the range touches them; floors only
+        // when their centre is inside it, which keeps sight symmetric
+        const bool centreInside =
+            column * row.startDenominator >= row.depth * row.startNumerator &&
+            column * row.endDenominator <= row.depth * row.endNumerator;
+        if ((wall || centreInside) && visible.contains(cell.x, cell.y) &&
+            row.depth * row.depth + column * column <= radiusSquared) {
+          visible.set(cell.x, cell.y, true);
+        }
+        if (previousSet && previousWall && !wall) {
+          // Leaving a wall: the range narrows to start at its far edge
+          row.startNumerator = 2 * column - 1;
+          row.startDenominator = 2 * row.depth;
+        } else if (previousSet && !previousWall && wall) {
+          // Entering a wall: the cells before it continue one row further
+          rows.push_back({row.depth + 1, row.startNumerator,
+                          row.startDenominator, 2 * column - 1,
+                          2 * row.depth});
+        }
+        previousWall = wall;
+        previousSet = true;
+      }
+      if (previousSet && !previousWall) {
+        rows.push_back({row.depth + 1, row.startNumerator,
+                        row.startDenominator, row.endNumerator,
+                        row.endDenominator});
+      }
+    }
+  }
+}
+
+void FieldOfView::clear() {
+  visible.fill(false);
+  origin = Point(-1, -1);
+  radius = -1;
+  stale = true;
+}
+
+bool FieldOfView::covers(const Point &cell) const {
+  return radius >= 0 && std::abs(cell.x - origin.x) <= radius &&
+         std::abs(cell.y - origin.y) <= radius;
+}
@@ -0,0 +1,56 @@
+#ifndef FIELD_OF_VIEW_H
+#define FIELD_OF_VIEW_H
+
+#include "utils/bit_grid.h"
+#include "utils/point.h"
+#include <vector>
+
+// Cells visible from one viewer, by symmetric shadowcasting: each of the
+// four quadrants around the origin is swept row by row, narrowing the
+// visible slope range at every wall. Slopes are kept as integer fractions,
+// so the result is exact. Visibility is symmetric between floor cells: if
+// A sees B then B sees A, so one viewer's field also answers "can that
+// cell see the viewer?".
+//
+// The field is cached: update() recomputes only when the viewer moves, the
+// radius changes or invalidate() was called since, e.g. because a cell in
+// range changed opacity.
+class FieldOfView {
+public:
+  // Recomputes from `origin` out to `radius` (a circle) over `opaque`,
+  // unless the last result still holds. Cells outside the grid block
+  // sight. Returns true if it recomputed.
+  bool update(const BitGrid &opaque, const Point &origin, int radius);
+  void compute(const BitGrid &opaque, const Point &origin, int radius);
+  // The next update() recomputes.
+  void invalidate() { stale = true; }
+  // Forgets the last compute; nothing is visible.
+  void clear();
+
+  bool isVisible(const Point &cell) const {
+    return visible.test(cell.x, cell.y);
+  }
+  // `cell` lies within the square the last compute swept, so a change to
+  // it can alter the result.
+  bool covers(const Point &cell) const;
+  const BitGrid &visibleCells() const { return visible; }
+  const Point &getOrigin() const { return origin; }
+  int getRadius() const { return radius; }
+
+private:
+  // A row of one quadrant, `depth` cells out, between two slopes
+  // (column / depth) given as fractions.
+  struct Row {
+    int depth;
+    int startNumerator, startDenominator;
+    int endNumerator, endDenominator;
+  };
+
+  BitGrid visible;
+  Point origin = Point(-1, -1);
+  int radius = -1;
+  bool stale = true;
+  std::vector<Row> rows; // Rows still to scan, kept between computes
+};
+
+#endif // FIELD_OF_VIEW_H
@@ -0,0 +1,135 @@
+#ifndef GRID_SEARCH_H
+#define GRID_SEARCH_H
+
+#include "algorithms/connectivity.h"
+#include "utils/point.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Reached when the search steps onto one given cell.
+struct CellGoal {
+  Point cell;
+  bool operator()(int x, int y) const { return x == cell.x && y == cell.y; }
+};
+
+// Breadth-first search over a width x height grid. What may be entered and
+// what counts as arrived are policies passed to run(), so each caller gets
+// its own inlined loop; connectivity is fixed per instance. Diagonal steps
+// may cut corners, like the distance field's.
+//
+// Buffers live in the instance and cells are stamped per run, so once they
+// have grown to the grid's size a run allocates nothing and costs
+// O(reached cells). Keep one instance per thread.
+template <Connectivity connectivity = Connectivity::Four> class GridSearch {
+public:
+  // Searches from `start` (always entered) through cells where
+  // isWalkable(x, y) holds, stopping at the first reached cell where
+  // isGoal(x, y) holds. Returns false if no such cell is reachable.
+  template <typename Walkable, typename Goal>
+  bool run(unsigned int gridWidth, unsigned int gridHeight,
+           const Point &start, Walkable isWalkable, Goal isGoal) {
+    width = static_cast<int>(gridWidth);
+    height = static_cast<int>(gridHeight);
+    goal = -1;
+    frontier.clear();
+    nextGeneration();
+    if (!contains(start.x, start.y)) {
+      return false;
+    }
+
+    const std::size_t area = static_cast<std::size_t>(width) * height;
+    if (area > stamps.size()) {
+      stamps.assign(area, 0);
+      parent.resize(area);
+      // Every cell enters the frontier at most once
+      frontier.reserve(area);
+    }
+
+    const int startCell = start.y * width + start.x;
+    reach(startCell, startCell);
+    for (std::size_t head = 0; head < frontier.size(); ++head) {
+      const int current = frontier[head];
+      const int cx = current % width;
+      const int cy = current / width;
+      if (isGoal(cx, cy)) {
+        goal = current;
+        return true;
+      }
+      for (std::size_t i = 0; i < stepCount; ++i) {
+        const int nx = cx + stepX[i];
+        const int ny = cy + stepY[i];
+        if (!contains(nx, ny)) {
+          continue;
+        }
+        const int next = ny * width + nx;
+        if (stamps[next] == generation || !isWalkable(nx, ny)) {
+          continue;
+        }
+        reach(next, current);
+      }
+    }
+    return false;
+  }
+
+  // Shortest path to the goal of the last successful run, start and goal
+  // included, written into `path` (whose capacity is reused).
+  void tracePath(std::vector<Point> &path) const {
+    path.clear();
+    if (goal < 0) {
+      return;
+    }
+    for (int step = goal;; step = parent[step]) {
+      path.emplace_back(step % width, step / width);
+      if (parent[step] == step) {
+        break;
+      }
+    }
+    std::reverse(path.begin(), path.end());
+  }
+
+  std::vector<Point> path() const {
+    std::vector<Point> result;
+    tracePath(result);
+    return result;
+  }
+
+  // Cells reached by the last run, the start included.
+  std::size_t reachedCount() const { return frontier.size(); }
+
+private:
+  static constexpr std::size_t stepCount =
+      connectivity == Connectivity::Four ? 4 : 8;
+  // Straight steps first, so 4-connected searches use the first four
+  static constexpr int stepX[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+  static constexpr int stepY[8] = {0, 0, 1, -1, 1, 1, -1, -1};
+
+  int width = 0;
+  int height = 0;
+  int goal = -1;
+  std::uint32_t generation = 0;
+  std::vector<std::uint32_t> stamps;
+  std::vector<int> parent;
+  // Reached cells in BFS order, doubling as the queue.
+  std::vector<int> frontier;
+
+  bool contains(int x, int y) const {
+    return x >= 0 && y >= 0 && x < width && y < height;
+  }
+
+  void nextGeneration() {
+    if (++generation == 0) {
+      std::fill(stamps.begin(), stamps.end(), 0);
+      generation = 1;
+    }
+  }
+
+  void reach(int cell, int from) {
+    stamps[cell] = generation;
+    parent[cell] = from;
+    frontier.push_back(cell);
+  }
+};
+
+#endif // GRID_SEARCH_H
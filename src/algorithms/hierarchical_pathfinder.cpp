@@ -0,0 +1,411 @@
+#include "hierarchical_pathfinder.h"
+#include <algorithm>
+#include <array>
+#include <climits>
+
+namespace {
+constexpr std::array<std::pair<int, int>, 4> directions = {
+    std::pair<int, int>{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+} // namespace
+
+void HierarchicalWorkspace::RegionSearch::prepare(int gridWidth,
+                                                  const MazeRoom *window) {
+  width = gridWidth;
+  if (window) {
+    left = window->x - 1;
+    top = window->y - 1;
+    windowWidth = window->width + 2;
+    windowHeight = window->height + 2;
+    windowSlot.assign(static_cast<std::size_t>(windowWidth) * windowHeight,
+                      -1);
+  } else {
+    windowWidth = 0;
+    slotOf.clear();
+  }
+  order.clear();
+  parent.clear();
+  distance.clear();
+}
+
+int HierarchicalWorkspace::RegionSearch::slot(int cell) const {
+  if (windowWidth == 0) {
+    const auto found = slotOf.find(cell);
+    return found == slotOf.end() ? -1 : found->second;
+  }
+  const int x = cell % width - left;
+  const int y = cell / width - top;
+  if (x < 0 || y < 0 || x >= windowWidth || y >= windowHeight) {
+    return -1;
+  }
+  return windowSlot[y * windowWidth + x];
+}
+
+void HierarchicalWorkspace::RegionSearch::visit(int cell, int from,
+                                                int steps) {
+  const int index = static_cast<int>(order.size());
+  if (windowWidth == 0) {
+    slotOf.emplace(cell, index);
+  } else {
+    windowSlot[(cell / width - top) * windowWidth + cell % width - left] =
+        index;
+  }
+  order.push_back(cell);
+  parent.push_back(from);
+  distance.push_back(steps);
+}
+
+void HierarchicalPathfinder::build(const BitGrid &walkable,
+                                   const std::vector<MazeRoom> &_rooms) {
+  width = static_cast<int>(walkable.getWidth());
+  height = static_cast<int>(walkable.getHeight());
+  rooms = _rooms;
+  roomCount = static_cast<int>(rooms.size());
+  corridorOf.reset(width, height, unassigned);
+  portalAt.clear();
+  portals.clear();
+  roomPortals.assign(rooms.size(), {});
+  links.clear();
+
+  constexpr int chunkMask = (1 << chunkBits) - 1;
+  chunksX = (width + chunkMask) >> chunkBits;
+  const int chunksY = (height + chunkMask) >> chunkBits;
+  roomsInChunk.assign(static_cast<std::size_t>(chunksX) * chunksY, {});
+  for (int r = 0; r < roomCount; ++r) {
+    const MazeRoom &room = rooms[r];
+    const int left = std::max(room.x, 0);
+    const int top = std::max(room.y, 0);
+    const int right = std::min(room.x + room.width, width);
+    const int bottom = std::min(room.y + room.height, height);
+    if (left >= right || top >= bottom) {
+      continue;
+    }
+    for (int cy = top >> chunkBits; cy <= (bottom - 1) >> chunkBits; ++cy) {
+      for (int cx = left >> chunkBits; cx <= (right - 1) >> chunkBits;
+           ++cx) {
+        roomsInChunk[cy * chunksX + cx].push_back(r);
+      }
+    }
+    // Walls left inside the rectangle are the only room cells labelled
+    for (int y = top; y < bottom; ++y) {
+      for (int x = left; x < right; ++x) {
+        if (!walkable.test(x, y)) {
+          corridorOf.set(x, y, blocked);
+        }
+      }
+    }
+  }
+  labelCorridors(walkable);
+
+  // A portal is a corridor cell right next to a room's interior: a
+  // corridor end or a gap in the room's wall
+  auto addPortal = [this](int r, int x, int y, int insideX, int insideY) {
+    if (regionAt(x, y) < roomCount || regionAt(insideX, insideY) != r) {
+      return;
+    }
+    const auto [entry, added] =
+        portalAt.emplace(y * width + x, static_cast<int>(portals.size()));
+    if (added) {
+      portals.emplace_back(x, y);
+    }
+    const int portal = entry->second;
+    std::vector<int> &bordering = roomPortals[r];
+    if (std::find(bordering.begin(), bordering.end(), portal) ==
+        bordering.end()) {
+      bordering.push_back(portal);
+    }
+  };
+  for (int r = 0; r < roomCount; ++r) {
+    const MazeRoom &room = rooms[r];
+    for (int x = room.x; x < room.x + room.width; ++x) {
+      addPortal(r, x, room.y - 1, x, room.y);
+      addPortal(r, x, room.y + room.height, x, room.y + room.height - 1);
+    }
+    for (int y = room.y; y < room.y + room.height; ++y) {
+      addPortal(r, room.x - 1, y, room.x, y);
+      addPortal(r, room.x + room.width, y, room.x + room.width - 1, y);
+    }
+  }
+
+  links.assign(portals.size(), {});
+  HierarchicalWorkspace::RegionSearch search;
+  for (int r = 0; r < roomCount; ++r) {
+    for (int portal : roomPortals[r]) {
+      const Point &p = portals[portal];
+      searchRegion(search, p.y * width + p.x, r);
+      linkPortals(search, portal, r);
+    }
+  }
+  // Each corridor only links the portals along it
+  for (std::size_t portal = 0; portal < portals.size(); ++portal) {
+    const Point &p = portals[portal];
+    const int region = regionAt(p.x, p.y);
+    searchRegion(search, p.y * width + p.x, region);
+    linkPortals(search, static_cast<int>(portal), region);
+  }
+}
+
+std::size_t HierarchicalPathfinder::memoryUsage() const {
+  std::size_t total = corridorOf.memoryUsage() +
+                      rooms.capacity() * sizeof(MazeRoom) +
+                      portals.capacity() * sizeof(Point) +
+                      portalAt.size() * 2 * sizeof(int);
+  for (const auto &chunk : roomsInChunk) {
+    total += sizeof(chunk) + chunk.capacity() * sizeof(int);
+  }
+  for (const auto &bordering : roomPortals) {
+    total += sizeof(bordering) + bordering.capacity() * sizeof(int);
+  }
+  for (const auto &portalLinks : links) {
+    total += sizeof(portalLinks) + portalLinks.capacity() * sizeof(Link);
+  }
+  return total;
+}
+
+int HierarchicalPathfinder::roomAt(int x, int y) const {
+  for (int r : roomsInChunk[(y >> chunkBits) * chunksX + (x >> chunkBits)]) {
+    const MazeRoom &room = rooms[r];
+    if (x >= room.x && x < room.x + room.width && y >= room.y &&
+        y < room.y + room.height) {
+      return r;
+    }
+  }
+  return -1;
+}
+
+int HierarchicalPathfinder::regionAt(int x, int y) const {
+  if (!contains(x, y)) {
+    return blocked;
+  }
+  const int label = corridorOf.get(x, y);
+  if (label != unassigned) {
+    return label;
+  }
+  const int room = roomAt(x, y);
+  return room >= 0 ? room : blocked;
+}
+
+bool HierarchicalPathfinder::inRegion(int x, int y, int region) const {
+  if (!contains(x, y)) {
+    return false;
+  }
+  if (!isRoom(region)) {
+    return corridorOf.get(x, y) == region;
+  }
+  const MazeRoom &room = rooms[region];
+  return x >= room.x && x < room.x + room.width && y >= room.y &&
+         y < room.y + room.height && corridorOf.get(x, y) == unassigned;
+}
+
+void HierarchicalPathfinder::labelCorridors(const BitGrid &walkable) {
+  int corridors = 0;
+  std::vector<Point> queue;
+  auto isUnlabelled = [this, &walkable](int x, int y) {
+    return walkable.test(x, y) && corridorOf.get(x, y) == unassigned &&
+           roomAt(x, y) < 0;
+  };
+  for (int y = 0; y < height; ++y) {
+    const BitGrid::Word *row = walkable.row(y);
+    for (unsigned int index = 0; index < walkable.getWordsPerRow(); ++index) {
+      BitGrid::forEachSetBit(index * BitGrid::wordBits, row[index],
+                             [&](int x) {
+        if (!isUnlabelled(x, y)) {
+          return;
+        }
+        const int region = roomCount + corridors++;
+        corridorOf.set(x, y, region);
+        queue.assign(1, Point(x, y));
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+          const Point current = queue[head];
+          for (const auto &[dx, dy] : directions) {
+            const int nx = current.x + dx;
+            const int ny = current.y + dy;
+            if (isUnlabelled(nx, ny)) {
+              corridorOf.set(nx, ny, region);
+              queue.emplace_back(nx, ny);
+            }
+          }
+        }
+      });
+    }
+  }
+}
+
+void HierarchicalPathfinder::searchRegion(
+    HierarchicalWorkspace::RegionSearch &search, int source, int region,
+    int target) const {
+  search.prepare(width, isRoom(region) ? &rooms[region] : nullptr);
+  search.visit(source, source, 0);
+
+  for (std::size_t head = 0; head < search.order.size(); ++head) {
+    if (target >= 0 && search.visited(target)) {
+      return;
+    }
+    const int current = search.order[head];
+    const int cx = current % width;
+    const int cy = current / width;
+    if (current != source && !inRegion(cx, cy, region)) {
+      continue; // A portal: the route leaves the region here
+    }
+    for (const auto &[dx, dy] : directions) {
+      const int nx = cx + dx;
+      const int ny = cy + dy;
+      if (!contains(nx, ny)) {
+        continue;
+      }
+      const int next = ny * width + nx;
+      if (search.visited(next)) {
+        continue;
+      }
+      if (inRegion(nx, ny, region) ||
+          (isRoom(region) && portalOf(next) >= 0)) {
+        search.visit(next, current, search.distance[head] + 1);
+      }
+    }
+  }
+}
+
+void HierarchicalPathfinder::linkPortals(
+    const HierarchicalWorkspace::RegionSearch &search, int from, int region) {
+  for (std::size_t slot = 0; slot < search.order.size(); ++slot) {
+    const int to = portalOf(search.order[slot]);
+    if (to < 0 || to == from) {
+      continue;
+    }
+    links[from].push_back({to, search.distance[slot], region});
+  }
+}
+
+std::vector<Point>
+HierarchicalPathfinder::findPath(HierarchicalWorkspace &workspace,
+                                 const Point &start,
+                                 const Point &goal) const {
+  std::vector<Point> path;
+  workspace.visitedCells = 0;
+  const int startRegion = regionAt(start.x, start.y);
+  const int goalRegion = regionAt(goal.x, goal.y);
+  if (startRegion == blocked || goalRegion == blocked) {
+    return path;
+  }
+  const int startCell = start.y * width + start.x;
+  const int goalCell = goal.y * width + goal.x;
+  if (startCell == goalCell) {
+    path.push_back(start);
+    return path;
+  }
+
+  // Local searches around both ends; they also settle the case of both
+  // ends sharing a region
+  HierarchicalWorkspace::RegionSearch &fromStart = workspace.fromStart;
+  HierarchicalWorkspace::RegionSearch &fromGoal = workspace.fromGoal;
+  searchRegion(fromStart, startCell, startRegion);
+  searchRegion(fromGoal, goalCell, goalRegion);
+  workspace.visitedCells = fromStart.order.size() + fromGoal.order.size();
+  int bestCost =
+      fromStart.visited(goalCell) ? fromStart.distanceTo(goalCell) : INT_MAX;
+  int bestPortal = -1; // -1: the direct route inside one region
+
+  // Dijkstra over the portal graph, seeded with the portals found around
+  // the start and stopping once nothing cheaper can reach the goal
+  if (portals.size() > workspace.portalStamps.size()) {
+    workspace.portalStamps.assign(portals.size(), 0);
+    workspace.portalCost.resize(portals.size());
+    workspace.previousPortal.resize(portals.size());
+    workspace.previousRegion.resize(portals.size());
+  }
+  if (++workspace.portalGeneration == 0) {
+    std::fill(workspace.portalStamps.begin(), workspace.portalStamps.end(),
+              0);
+    workspace.portalGeneration = 1;
+  }
+  std::vector<std::pair<int, int>> &heap = workspace.heap;
+  heap.clear();
+  auto relax = [&workspace, &heap](int portal, int cost, int previous,
+                                   int region) {
+    if (workspace.portalStamps[portal] == workspace.portalGeneration &&
+        workspace.portalCost[portal] <= cost) {
+      return;
+    }
+    workspace.portalStamps[portal] = workspace.portalGeneration;
+    workspace.portalCost[portal] = cost;
+    workspace.previousPortal[portal] = previous;
+    workspace.previousRegion[portal] = region;
+    heap.emplace_back(-cost, portal);
+    std::push_heap(heap.begin(), heap.end());
+  };
+  for (std::size_t slot = 0; slot < fromStart.order.size(); ++slot) {
+    const int portal = portalOf(fromStart.order[slot]);
+    if (portal >= 0) {
+      relax(portal, fromStart.distance[slot], -1, -1);
+    }
+  }
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end());
+    const auto [negativeCost, portal] = heap.back();
+    heap.pop_back();
+    const int cost = -negativeCost;
+    if (cost > workspace.portalCost[portal]) {
+      continue; // Stale entry
+    }
+    if (cost >= bestCost) {
+      break;
+    }
+    const Point &p = portals[portal];
+    const int cell = p.y * width + p.x;
+    if (fromGoal.visited(cell) &&
+        cost + fromGoal.distanceTo(cell) < bestCost) {
+      bestCost = cost + fromGoal.distanceTo(cell);
+      bestPortal = portal;
+    }
+    for (const Link &link : links[portal]) {
+      relax(link.to, cost + link.cost, portal, link.region);
+    }
+  }
+
+  if (bestCost == INT_MAX) {
+    return path;
+  }
+  if (bestPortal < 0) {
+    for (int step = goalCell; step != startCell;
+         step = fromStart.parentOf(step)) {
+      path.emplace_back(step % width, step / width);
+    }
+    path.push_back(start);
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+
+  // Start to the first portal, the portal hops, then the last portal to
+  // the goal, whose search parents already point goalward
+  std::vector<int> chain; // Portals from the last back to the first
+  for (int portal = bestPortal; portal >= 0;
+       portal = workspace.previousPortal[portal]) {
+    chain.push_back(portal);
+  }
+  const Point &first = portals[chain.back()];
+  for (int step = first.y * width + first.x; step != startCell;
+       step = fromStart.parentOf(step)) {
+    path.emplace_back(step % width, step / width);
+  }
+  path.push_back(start);
+  std::reverse(path.begin(), path.end());
+  HierarchicalWorkspace::RegionSearch &hop = workspace.hop;
+  for (std::size_t i = chain.size() - 1; i > 0; --i) {
+    const Point &from = portals[chain[i]];
+    const Point &to = portals[chain[i - 1]];
+    const int fromCell = from.y * width + from.x;
+    const int toCell = to.y * width + to.x;
+    searchRegion(hop, fromCell, workspace.previousRegion[chain[i - 1]],
+                 toCell);
+    const std::size_t hopStart = path.size();
+    for (int step = toCell; step != fromCell; step = hop.parentOf(step)) {
+      path.emplace_back(step % width, step / width);
+    }
+    std::reverse(path.begin() + hopStart, path.end());
+  }
+  const Point &last = portals[bestPortal];
+  for (int step = last.y * width + last.x; step != goalCell;) {
+    step = fromGoal.parentOf(step);
+    path.emplace_back(step % width, step / width);
+  }
+  return path;
+}
@@ -0,0 +1,153 @@
+#ifndef HIERARCHICAL_PATHFINDER_H
+#define HIERARCHICAL_PATHFINDER_H
+
+#include "algorithms/maze_generator.h"
+#include "utils/bit_grid.h"
+#include "utils/chunked_grid.h"
+#include "utils/point.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Scratch state for HierarchicalPathfinder queries, reused across them.
+// Keep one per thread; the pathfinder itself is read-only once built.
+class HierarchicalWorkspace {
+  friend class HierarchicalPathfinder;
+
+  // One breadth-first search confined to a single region. Room searches
+  // index their cells inside the room's rectangle plus its border; corridor
+  // searches hash the cells they reach. Either way the search grows with
+  // the region rather than the map.
+  struct RegionSearch {
+    int left = 0;
+    int top = 0;
+    int windowWidth = 0; // 0 while hashing
+    int windowHeight = 0;
+    std::vector<int> windowSlot; // Per window cell: index into order, or -1
+    std::unordered_map<int, int> slotOf; // Cell -> index into order
+    std::vector<int> order;              // Visited cells, in BFS order
+    std::vector<int> parent;             // Per slot: cell reached from
+    std::vector<int> distance;           // Per slot
+
+    // Starts over; a search over a room covers just `window`.
+    void prepare(int width, const MazeRoom *window);
+    void visit(int cell, int from, int steps);
+    int slot(int cell) const;
+    bool visited(int cell) const { return slot(cell) >= 0; }
+    int distanceTo(int cell) const { return distance[slot(cell)]; }
+    int parentOf(int cell) const { return parent[slot(cell)]; }
+
+  private:
+    int width = 0; // Of the grid, to split cells into x and y
+  };
+
+  RegionSearch fromStart;
+  RegionSearch fromGoal;
+  RegionSearch hop; // Retraces one portal-to-portal link
+
+  // Dijkstra over portals
+  std::uint32_t portalGeneration = 0;
+  std::vector<std::uint32_t> portalStamps;
+  std::vector<int> portalCost;
+  std::vector<int> previousPortal;
+  std::vector<int> previousRegion; // Region crossed from previousPortal
+  std::vector<std::pair<int, int>> heap; // (-cost, portal)
+
+  std::size_t visitedCells = 0;
+
+public:
+  // Cells touched by the local searches around both ends of the last
+  // query. The portal graph in between is walked without touching cells;
+  // only the links on the final path are retraced, each stopping at its
+  // far portal.
+  std::size_t getVisitedCells() const { return visitedCells; }
+};
+
+// HPA*-style planner for room-based levels. Cells are split into regions:
+// the open interior of each room, and each connected piece of walkable
+// cells outside rooms (a corridor). Portals are the corridor cells
+// touching a room, and the portal graph links every pair of portals that
+// share a region with the length of the shortest route through it,
+// precomputed by build(). The routes themselves are not kept; a query
+// retraces the few it uses.
+//
+// A query searches only the regions holding its two ends, then crosses
+// the portal graph, so long routes cost about O(rooms) rather than
+// O(cells). Paths are 4-connected and as short as a plain BFS over the
+// same cells. They reflect the walkable cells given to the last build().
+//
+// Rooms are kept as rectangles, assumed not to overlap; only corridor
+// cells (and walls inside a room's rectangle) are labelled, in 64x64
+// chunks, so memory follows the carved corridors rather than the map's
+// bounding box.
+class HierarchicalPathfinder {
+public:
+  void build(const BitGrid &walkable, const std::vector<MazeRoom> &rooms);
+
+  // Shortest path, start and goal included; empty if either end is not
+  // walkable or the goal cannot be reached.
+  std::vector<Point> findPath(HierarchicalWorkspace &workspace,
+                              const Point &start, const Point &goal) const;
+
+  std::size_t getPortalCount() const { return portals.size(); }
+  std::size_t memoryUsage() const;
+
+private:
+  static constexpr int blocked = -2;
+  static constexpr int unassigned = -1;
+  static constexpr int chunkBits = 6;
+
+  struct Link {
+    int to;
+    int cost;
+    int region; // Crossed on the way; retraced through it when needed
+  };
+
+  int width = 0;
+  int height = 0;
+  // Regions below this are rooms, indexed like the rooms given to build();
+  // the rest are corridors.
+  int roomCount = 0;
+  std::vector<MazeRoom> rooms;
+  // Per 64x64 chunk: the rooms overlapping it.
+  std::vector<std::vector<int>> roomsInChunk;
+  int chunksX = 0;
+  // Per cell: its corridor region, blocked for walls inside a room's
+  // rectangle, unassigned for everything else.
+  ChunkedGrid<int, chunkBits> corridorOf;
+  // Cell -> index into portals.
+  std::unordered_map<int, int> portalAt;
+  std::vector<Point> portals;
+  std::vector<std::vector<int>> roomPortals;
+  std::vector<std::vector<Link>> links;
+
+  bool contains(int x, int y) const {
+    return x >= 0 && y >= 0 && x < width && y < height;
+  }
+  bool isRoom(int region) const { return region >= 0 && region < roomCount; }
+  // Room whose rectangle holds (x, y), -1 if none.
+  int roomAt(int x, int y) const;
+  // Region holding (x, y), or blocked.
+  int regionAt(int x, int y) const;
+  bool inRegion(int x, int y, int region) const;
+  int portalOf(int cell) const {
+    const auto found = portalAt.find(cell);
+    return found == portalAt.end() ? -1 : found->second;
+  }
+
+  // Gives every connected piece of walkable cells outside the rooms a
+  // corridor region of its own.
+  void labelCorridors(const BitGrid &walkable);
+
+  // Breadth-first search from `source` through the cells of `region`,
+  // stopping early once `target` is reached. Portals bordering a room
+  // region are reached but not expanded.
+  void searchRegion(HierarchicalWorkspace::RegionSearch &search, int source,
+                    int region, int target = -1) const;
+  void linkPortals(const HierarchicalWorkspace::RegionSearch &search,
+                   int from, int region);
+};
+
+#endif // HIERARCHICAL_PATHFINDER_H
@@ -1,5 +1,22 @@
 #include "maze_generator.h"
-#include <functional>
+#include <future>
+
+namespace {
+// Seed of one stream derived from another, so every BSP node draws from
+// its own generator whichever thread gets to it first.
+std::uint32_t deriveSeed(std::uint32_t seed, std::uint32_t salt) {
+  std::uint32_t mixed = seed + 0x9E3779B9u * (salt + 1);
+  mixed = (mixed ^ (mixed >> 16)) * 0x85EBCA6Bu;
+  mixed = (mixed ^ (mixed >> 13)) * 0xC2B2AE35u;
+  return mixed ^ (mixed >> 16);
+}
+
+// Salts of the streams each node draws from.
+constexpr std::uint32_t leftChild = 0;
+constexpr std::uint32_t rightChild = 1;
+constexpr std::uint32_t roomStream = 2;
+constexpr std::uint32_t corridorStream = 3;
+} // namespace
 
 auto MazeGenerator::getNeighbors(unsigned int x, unsigned int y) const
     -> std::vector<std::pair<unsigned int, unsigned int>> {
@@ -37,7 +54,7 @@ void MazeGenerator::generateRecursiveDFS() {
    */
   std::pair<unsigned int, unsigned int> current = this->start;
   std::vector<std::pair<unsigned int, unsigned int>> stack = {current};
-  std::default_random_engine random_engine(time(0));
+  std::default_random_engine random_engine(seed);
   while (!stack.empty()) {
     current = stack.back();
     if (current == this->end) {
@@ -46,17 +63,17 @@ void MazeGenerator::generateRecursiveDFS() {
       }
     }
     stack.pop_back();
-    this->maze[current.second][current.first] = ' ';
+    this->canvas->open(current.first, current.second);
     auto neighbors = this->getNeighbors(current.first, current.second);
     std::shuffle(neighbors.begin(), neighbors.end(), random_engine);
     for (auto neighbor : neighbors) {
-      if (this->maze[neighbor.second][neighbor.first] == '#') {
+      if (!this->canvas->isOpen(neighbor.first, neighbor.second)) {
         stack.push_back(neighbor);
       }
     }
   }
   // mark end with ' '
-  this->maze[end.second][end.first] = ' ';
+  this->canvas->open(end.first, end.second);
 }
 
 void MazeGenerator::generateRandomizedPrim() {
@@ -69,7 +86,7 @@ void MazeGenerator::generateRandomizedPrim() {
       queue;
   std::pair<unsigned int, unsigned int> current = this->start;
   queue.push(std::make_pair(0, current));
-  std::default_random_engine random_engine(time(0));
+  std::default_random_engine random_engine(seed);
   std::uniform_int_distribution<size_t> distribution(0, 100);
   while (!queue.empty()) {
     auto currentDistance = queue.top().first;
@@ -80,32 +97,65 @@ void MazeGenerator::generateRandomizedPrim() {
       }
     }
     queue.pop();
-    this->maze[current.second][current.first] = ' ';
+    this->canvas->open(current.first, current.second);
     auto neighbors = this->getNeighbors(current.first, current.second);
     for (auto neighbor : neighbors) {
-      if (this->maze[neighbor.second][neighbor.first] == '#') {
+      if (!this->canvas->isOpen(neighbor.first, neighbor.second)) {
         auto distance = distribution(random_engine);
         queue.push(std::make_pair(currentDistance + distance, neighbor));
       }
     }
   }
   // mark end with ' '
-  this->maze[end.second][end.first] = ' ';
+  this->canvas->open(end.first, end.second);
+}
+
+MazeGenerator::MazeGenerator(int width, int height,
+                             MazeGeneratorAlgorithm algorithm,
+                             std::uint32_t seed, unsigned int threads)
+    : seed(seed), threads(std::max(1u, threads)),
+      maze(height, std::string(width, '#')),
+      ownCanvas(std::make_unique<StringMazeCanvas>(maze)) {
+  /**
+   * @brief Constructs a new MazeGenerator object carving into its own rows
+   * of characters, read back through getMaze().
+   * @param width The width of the maze.
+   * @param height The height of the maze.
+   * @param algorithm The algorithm to use to generate the maze.
+   * @param seed Seeds every random choice; the same seed, size and
+   * algorithm always give the same maze.
+   * @param threads Threads BSP generation may use.
+   * @return MazeGenerator object.
+   */
+  generate(width, height, algorithm, *ownCanvas);
 }
 
 MazeGenerator::MazeGenerator(int width, int height,
-                             MazeGeneratorAlgorithm algorithm) {
+                             MazeGeneratorAlgorithm algorithm,
+                             MazeCanvas &output, std::uint32_t seed,
+                             unsigned int threads)
+    : seed(seed), threads(std::max(1u, threads)) {
   /**
-   * @brief Constructs a new MazeGenerator object.
+   * @brief Constructs a new MazeGenerator object carving straight into the
+   * caller's canvas; getMaze() stays empty.
    * @param width The width of the maze.
    * @param height The height of the maze.
    * @param algorithm The algorithm to use to generate the maze.
+   * @param output Canvas of width x height cells, all wall.
+   * @param seed Seeds every random choice.
+   * @param threads Threads BSP generation may use.
    * @return MazeGenerator object.
    */
+  generate(width, height, algorithm, output);
+}
+
+void MazeGenerator::generate(int width, int height,
+                             MazeGeneratorAlgorithm algorithm,
+                             MazeCanvas &output) {
   this->width = width;
   this->height = height;
   this->algorithm = algorithm;
-  this->maze = std::vector<std::string>(height, std::string(width, '#'));
+  this->canvas = &output;
   this->start = std::make_pair(1, 1);
   this->end = std::make_pair(width - 2, height - 2);
   switch (algorithm) {
@@ -124,9 +174,9 @@ MazeGenerator::MazeGenerator(int width, int height,
   }
 }
 
-auto MazeGenerator::getMaze() -> std::vector<std::string> {
+auto MazeGenerator::getMaze() const -> const std::vector<std::string> & {
   /**
-   * @brief Returns the maze.
+   * @brief Returns the maze, when generated into the generator's own rows.
    * @return The maze.
    */
   return this->maze;
@@ -148,44 +198,51 @@ auto MazeGenerator::getEnd() -> std::pair<unsigned int, unsigned int> {
   return this->end;
 }
 
+auto MazeGenerator::getRoomGraph() const -> const MazeRoomGraph & {
+  /**
+   * @brief Returns the rooms and corridors of a room-based maze.
+   * @return The room graph.
+   */
+  return this->roomGraph;
+}
+
 void MazeGenerator::generateBSP() {
   // BSP dungeon generation - creates distinct rooms connected by narrow corridors
-  std::default_random_engine rng(time(0));
-  
-  // Create root node covering entire dungeon (minus border)
-  BSPNode* root = new BSPNode();
-  root->x = 1;
-  root->y = 1;
-  root->width = width - 2;
-  root->height = height - 2;
-  
-  // Recursively split the space
-  splitBSP(root, 0, rng);
-  
-  // Create rooms in leaf nodes
-  createRooms(root, rng);
-  
-  // Connect rooms with narrow corridors
-  connectRooms(root, rng);
-  
-  // Collect all rooms
-  std::vector<BSPNode*> leaves;
-  std::queue<BSPNode*> queue;
-  queue.push(root);
-  while (!queue.empty()) {
-    BSPNode* node = queue.front();
-    queue.pop();
-    if (node->hasRoom) {
-      leaves.push_back(node);
-    }
-    if (node->left) queue.push(node->left);
-    if (node->right) queue.push(node->right);
+
+  // Root node covers the entire dungeon (minus border)
+  bspTree.assign((std::size_t{2} << bspMaxDepth) - 1, BSPNode());
+  BSPNode &root = bspTree[0];
+  root.x = 1;
+  root.y = 1;
+  root.width = width - 2;
+  root.height = height - 2;
+  root.seed = seed;
+
+  // Split the space and place rooms; sibling subtrees cover disjoint
+  // rectangles, so the top levels hand one side to another thread. Rooms
+  // are carved there too when the canvas takes concurrent writes.
+  int taskDepth = 0;
+  while ((1u << taskDepth) < threads) {
+    ++taskDepth;
   }
-  
+  const bool carveInTasks = taskDepth > 0 && canvas->allowsConcurrentOpen();
+  buildSubtree(0, 0, taskDepth, carveInTasks);
+
+  // Number the rooms left to right, then connect them with narrow
+  // corridors, which cross partitions and so are carved on this thread
+  indexRooms(!carveInTasks);
+  connectRooms();
+
+  // Rooms in breadth-first order, which settles ties below
+  std::vector<const BSPNode*> leaves;
+  for (const BSPNode &node : bspTree) {
+    if (node.hasRoom) leaves.push_back(&node);
+  }
+
   if (!leaves.empty()) {
     // Start in top-left-most room
-    BSPNode* startRoom = leaves.front();
-    for (auto* leaf : leaves) {
+    const BSPNode* startRoom = leaves.front();
+    for (const auto* leaf : leaves) {
       if (leaf->roomX + leaf->roomY < startRoom->roomX + startRoom->roomY) {
         startRoom = leaf;
       }
@@ -193,8 +250,8 @@ void MazeGenerator::generateBSP() {
     this->start = {startRoom->roomX + 1, startRoom->roomY + 1};
     
     // End in bottom-right-most room
-    BSPNode* endRoom = leaves.back();
-    for (auto* leaf : leaves) {
+    const BSPNode* endRoom = leaves.back();
+    for (const auto* leaf : leaves) {
       if (leaf->roomX + leaf->roomY > endRoom->roomX + endRoom->roomY) {
         endRoom = leaf;
       }
@@ -202,169 +259,176 @@ void MazeGenerator::generateBSP() {
     this->end = {endRoom->roomX + endRoom->roomW - 2,
                  endRoom->roomY + endRoom->roomH - 2};
   }
-  
+
   // Mark start and end
-  this->maze[start.second][start.first] = ' ';
-  this->maze[end.second][end.first] = ' ';
-  
-  // Clean up BSP tree
-  std::function<void(BSPNode*)> cleanup = [&](BSPNode* node) {
-    if (!node) return;
-    cleanup(node->left);
-    cleanup(node->right);
-    delete node;
-  };
-  cleanup(root);
+  this->canvas->open(start.first, start.second);
+  this->canvas->open(end.first, end.second);
+}
+
+void MazeGenerator::buildSubtree(int root, int rootDepth, int taskDepth,
+                                 bool carve) {
+  std::vector<std::future<void>> tasks;
+  std::vector<std::pair<int, int>> pending{{root, rootDepth}};
+  while (!pending.empty()) {
+    const int index = pending.back().first;
+    const int depth = pending.back().second;
+    pending.pop_back();
+    splitBSP(index, depth);
+    BSPNode &node = bspTree[index];
+    if (node.left < 0) {
+      createRoom(node);
+      if (carve && node.hasRoom) carveRoom(node);
+      continue;
+    }
+    if (depth < taskDepth) {
+      tasks.push_back(std::async(std::launch::async,
+                                 &MazeGenerator::buildSubtree, this,
+                                 node.left, depth + 1, taskDepth, carve));
+    } else {
+      pending.emplace_back(node.left, depth + 1);
+    }
+    pending.emplace_back(node.right, depth + 1);
+  }
+  for (auto &task : tasks) {
+    task.get();
+  }
 }
 
-void MazeGenerator::splitBSP(BSPNode* node, int depth, std::default_random_engine& rng) {
+void MazeGenerator::splitBSP(int index, int depth) {
   const int MIN_SIZE = 25;  // Larger minimum partition for bigger rooms
-  const int MAX_DEPTH = 7;  // More splits = more rooms
+  BSPNode &node = bspTree[index];
   
-  if (depth >= MAX_DEPTH) return;
-  if (node->width < MIN_SIZE * 2 && node->height < MIN_SIZE * 2) return;
+  if (depth >= bspMaxDepth) return;
+  if (node.width < MIN_SIZE * 2 && node.height < MIN_SIZE * 2) return;
+  std::default_random_engine rng(node.seed);
   
   // Decide split direction based on aspect ratio
   bool splitHorizontal;
-  if (node->width > node->height * 1.25) {
+  if (node.width > node.height * 1.25) {
     splitHorizontal = false; // Split vertically (left/right)
-  } else if (node->height > node->width * 1.25) {
+  } else if (node.height > node.width * 1.25) {
     splitHorizontal = true;  // Split horizontally (top/bottom)
   } else {
     std::uniform_int_distribution<int> coinFlip(0, 1);
     splitHorizontal = coinFlip(rng) == 0;
   }
   
-  int max = (splitHorizontal ? node->height : node->width) - MIN_SIZE;
+  int max = (splitHorizontal ? node.height : node.width) - MIN_SIZE;
   if (max <= MIN_SIZE) return;
   
   std::uniform_int_distribution<int> splitDist(MIN_SIZE, max);
   int split = splitDist(rng);
   
-  node->left = new BSPNode();
-  node->right = new BSPNode();
+  node.left = 2 * index + 1;
+  node.right = 2 * index + 2;
+  BSPNode &left = bspTree[node.left];
+  BSPNode &right = bspTree[node.right];
+  left.seed = deriveSeed(node.seed, leftChild);
+  right.seed = deriveSeed(node.seed, rightChild);
   
   if (splitHorizontal) {
-    node->left->x = node->x;
-    node->left->y = node->y;
-    node->left->width = node->width;
-    node->left->height = split;
+    left.x = node.x;
+    left.y = node.y;
+    left.width = node.width;
+    left.height = split;
     
-    node->right->x = node->x;
-    node->right->y = node->y + split;
-    node->right->width = node->width;
-    node->right->height = node->height - split;
+    right.x = node.x;
+    right.y = node.y + split;
+    right.width = node.width;
+    right.height = node.height - split;
   } else {
-    node->left->x = node->x;
-    node->left->y = node->y;
-    node->left->width = split;
-    node->left->height = node->height;
+    left.x = node.x;
+    left.y = node.y;
+    left.width = split;
+    left.height = node.height;
     
-    node->right->x = node->x + split;
-    node->right->y = node->y;
-    node->right->width = node->width - split;
-    node->right->height = node->height;
+    right.x = node.x + split;
+    right.y = node.y;
+    right.width = node.width - split;
+    right.height = node.height;
   }
-  
-  splitBSP(node->left, depth + 1, rng);
-  splitBSP(node->right, depth + 1, rng);
 }
 
-void MazeGenerator::createRooms(BSPNode* node, std::default_random_engine& rng) {
-  if (!node) return;
-  
-  if (node->left || node->right) {
-    // Not a leaf, recurse
-    createRooms(node->left, rng);
-    createRooms(node->right, rng);
-    return;
-  }
-  
+void MazeGenerator::createRoom(BSPNode &node) {
   // Leaf node - create a room with walls
   const int MIN_ROOM = 20;  // Bigger minimum room size
   const int PADDING = 2;    // Space between room and partition edge
   
-  int maxW = node->width - PADDING * 2;
-  int maxH = node->height - PADDING * 2;
+  int maxW = node.width - PADDING * 2;
+  int maxH = node.height - PADDING * 2;
   
   if (maxW < MIN_ROOM || maxH < MIN_ROOM) return;
+  std::default_random_engine rng(deriveSeed(node.seed, roomStream));
   
   // Room size - allow larger rooms (fill most of partition)
   std::uniform_int_distribution<int> wDist(MIN_ROOM, std::min(maxW, 48));
   std::uniform_int_distribution<int> hDist(MIN_ROOM, std::min(maxH, 36));
   
-  node->roomW = wDist(rng);
-  node->roomH = hDist(rng);
+  node.roomW = wDist(rng);
+  node.roomH = hDist(rng);
   
   // Position room within partition
-  int xRange = node->width - node->roomW - PADDING;
-  int yRange = node->height - node->roomH - PADDING;
+  int xRange = node.width - node.roomW - PADDING;
+  int yRange = node.height - node.roomH - PADDING;
   
   std::uniform_int_distribution<int> xDist(0, std::max(0, xRange));
   std::uniform_int_distribution<int> yDist(0, std::max(0, yRange));
   
-  node->roomX = node->x + PADDING + xDist(rng);
-  node->roomY = node->y + PADDING + yDist(rng);
-  node->hasRoom = true;
-  
+  node.roomX = node.x + PADDING + xDist(rng);
+  node.roomY = node.y + PADDING + yDist(rng);
+  // Interior center (accounting for walls)
+  node.centerX = node.roomX + node.roomW / 2;
+  node.centerY = node.roomY + node.roomH / 2;
+  node.hasRoom = true;
+}
+
+void MazeGenerator::carveRoom(const BSPNode &node) {
   // Carve room interior (leave walls as '#')
-  for (int y = node->roomY + 1; y < node->roomY + node->roomH - 1; ++y) {
-    for (int x = node->roomX + 1; x < node->roomX + node->roomW - 1; ++x) {
+  for (int y = node.roomY + 1; y < node.roomY + node.roomH - 1; ++y) {
+    for (int x = node.roomX + 1; x < node.roomX + node.roomW - 1; ++x) {
       if (y >= 0 && y < static_cast<int>(height) && 
           x >= 0 && x < static_cast<int>(width)) {
-        this->maze[y][x] = ' ';
+        this->canvas->open(x, y);
       }
     }
   }
 }
 
-std::pair<int, int> MazeGenerator::getRoomCenter(BSPNode* node) {
-  if (!node) return {-1, -1};
-  
-  if (node->hasRoom) {
-    // Return interior center (accounting for walls)
-    return {node->roomX + node->roomW / 2, node->roomY + node->roomH / 2};
-  }
-  
-  // Get center from children
-  if (node->left) {
-    auto center = getRoomCenter(node->left);
-    if (center.first >= 0) return center;
+void MazeGenerator::indexRooms(bool carve) {
+  // Children come after their parent, so one backward pass finds each
+  // subtree's leftmost room
+  for (int i = static_cast<int>(bspTree.size()) - 1; i >= 0; --i) {
+    BSPNode &node = bspTree[i];
+    if (node.hasRoom) {
+      node.firstRoom = i;
+    } else if (node.left >= 0) {
+      const int leftRoom = bspTree[node.left].firstRoom;
+      node.firstRoom = leftRoom >= 0 ? leftRoom : bspTree[node.right].firstRoom;
+    }
   }
-  if (node->right) {
-    auto center = getRoomCenter(node->right);
-    if (center.first >= 0) return center;
+
+  // Left before right, the order rooms are numbered in
+  std::vector<int> pending{0};
+  while (!pending.empty()) {
+    BSPNode &node = bspTree[pending.back()];
+    pending.pop_back();
+    if (node.hasRoom) {
+      node.roomIndex = static_cast<int>(roomGraph.rooms.size());
+      roomGraph.rooms.push_back(
+          {node.roomX + 1, node.roomY + 1, node.roomW - 2, node.roomH - 2});
+      if (carve) carveRoom(node);
+    }
+    if (node.left >= 0) {
+      pending.push_back(node.right);
+      pending.push_back(node.left);
+    }
   }
-  
-  return {-1, -1};
 }
 
-std::pair<int, int> MazeGenerator::getRoomEdge(BSPNode* node, int dirX, int dirY) {
-  // Get a point on the room edge in the given direction (for corridor connection)
-  if (!node) return {-1, -1};
-  
-  if (node->hasRoom) {
-    int cx = node->roomX + node->roomW / 2;
-    int cy = node->roomY + node->roomH / 2;
-    
-    if (dirX > 0) return {node->roomX + node->roomW - 1, cy}; // Right edge
-    if (dirX < 0) return {node->roomX, cy};                    // Left edge
-    if (dirY > 0) return {cx, node->roomY + node->roomH - 1}; // Bottom edge
-    if (dirY < 0) return {cx, node->roomY};                    // Top edge
-    return {cx, cy};
-  }
-  
-  // Get from children
-  if (node->left) {
-    auto edge = getRoomEdge(node->left, dirX, dirY);
-    if (edge.first >= 0) return edge;
-  }
-  if (node->right) {
-    auto edge = getRoomEdge(node->right, dirX, dirY);
-    if (edge.first >= 0) return edge;
-  }
-  
-  return {-1, -1};
+std::pair<int, int> MazeGenerator::getRoomCenter(int node) const {
+  const int room = bspTree[node].firstRoom;
+  if (room < 0) return {-1, -1};
+  return {bspTree[room].centerX, bspTree[room].centerY};
 }
 
 void MazeGenerator::carveHorizontalCorridor(int x1, int x2, int y) {
@@ -373,7 +437,7 @@ void MazeGenerator::carveHorizontalCorridor(int x1, int x2, int y) {
   for (int x = minX; x <= maxX; ++x) {
     if (y >= 0 && y < static_cast<int>(height) && 
         x >= 0 && x < static_cast<int>(width)) {
-      this->maze[y][x] = ' ';
+      this->canvas->open(x, y);
     }
   }
 }
@@ -384,42 +448,49 @@ void MazeGenerator::carveVerticalCorridor(int y1, int y2, int x) {
   for (int y = minY; y <= maxY; ++y) {
     if (y >= 0 && y < static_cast<int>(height) && 
         x >= 0 && x < static_cast<int>(width)) {
-      this->maze[y][x] = ' ';
+      this->canvas->open(x, y);
     }
   }
 }
 
-void MazeGenerator::connectRooms(BSPNode* node, std::default_random_engine& rng) {
-  if (!node) return;
-  if (!node->left || !node->right) return;
-  
-  // Recursively connect children first
-  connectRooms(node->left, rng);
-  connectRooms(node->right, rng);
-  
-  // Determine connection direction based on how nodes are arranged
-  auto leftCenter = getRoomCenter(node->left);
-  auto rightCenter = getRoomCenter(node->right);
-  
-  if (leftCenter.first < 0 || rightCenter.first < 0) return;
-  
-  // Get room edges facing each other for connection
-  int dx = (rightCenter.first > leftCenter.first) ? 1 : -1;
-  int dy = (rightCenter.second > leftCenter.second) ? 1 : -1;
-  
-  // Determine if rooms are more horizontal or vertical from each other
-  int horizDist = std::abs(rightCenter.first - leftCenter.first);
-  int vertDist = std::abs(rightCenter.second - leftCenter.second);
-  
-  // Create L-shaped corridor connecting room interiors
-  std::uniform_int_distribution<int> coinFlip(0, 1);
-  if (coinFlip(rng) == 0) {
-    // Horizontal first, then vertical
-    carveHorizontalCorridor(leftCenter.first, rightCenter.first, leftCenter.second);
-    carveVerticalCorridor(leftCenter.second, rightCenter.second, rightCenter.first);
-  } else {
-    // Vertical first, then horizontal
-    carveVerticalCorridor(leftCenter.second, rightCenter.second, leftCenter.first);
-    carveHorizontalCorridor(leftCenter.first, rightCenter.first, rightCenter.second);
+void MazeGenerator::connectRooms() {
+  // Children are connected before their parent: walk node, right, left
+  // and replay that backwards
+  std::vector<int> order;
+  std::vector<int> pending{0};
+  while (!pending.empty()) {
+    const int index = pending.back();
+    pending.pop_back();
+    const BSPNode &node = bspTree[index];
+    if (node.left < 0) continue;
+    order.push_back(index);
+    pending.push_back(node.left);
+    pending.push_back(node.right);
+  }
+
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const BSPNode &node = bspTree[*it];
+    std::default_random_engine rng(deriveSeed(node.seed, corridorStream));
+
+    // Determine connection direction based on how nodes are arranged
+    auto leftCenter = getRoomCenter(node.left);
+    auto rightCenter = getRoomCenter(node.right);
+
+    if (leftCenter.first < 0 || rightCenter.first < 0) continue;
+    roomGraph.corridors.emplace_back(
+        bspTree[bspTree[node.left].firstRoom].roomIndex,
+        bspTree[bspTree[node.right].firstRoom].roomIndex);
+
+    // Create L-shaped corridor connecting room interiors
+    std::uniform_int_distribution<int> coinFlip(0, 1);
+    if (coinFlip(rng) == 0) {
+      // Horizontal first, then vertical
+      carveHorizontalCorridor(leftCenter.first, rightCenter.first, leftCenter.second);
+      carveVerticalCorridor(leftCenter.second, rightCenter.second, rightCenter.first);
+    } else {
+      // Vertical first, then horizontal
+      carveVerticalCorridor(leftCenter.second, rightCenter.second, leftCenter.first);
+      carveHorizontalCorridor(leftCenter.first, rightCenter.first, rightCenter.second);
+    }
   }
 }
@@ -2,7 +2,9 @@
 #define MAZE_GENERATOR_H
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <queue>
 #include <random>
 #include <stack>
@@ -31,6 +33,48 @@ enum class MazeGeneratorAlgorithm {
   Unknown
 };
 
+// Open interior of one generated room, in maze cells.
+struct MazeRoom {
+  int x, y, width, height;
+
+  bool contains(int px, int py) const {
+    return px >= x && py >= y && px < x + width && py < y + height;
+  }
+};
+
+// Rooms of a room-based maze and the corridors the generator dug between
+// them, each as a pair of indices into `rooms`. Corridors may cut through
+// other rooms on their way, so the carved cells stay the ground truth for
+// who actually connects to whom.
+struct MazeRoomGraph {
+  std::vector<MazeRoom> rooms;
+  std::vector<std::pair<int, int>> corridors;
+};
+
+// Where a generator carves. Every cell starts as wall; generators only
+// open cells and read back which ones are open, so any storage can sit
+// behind a canvas and the level is written exactly once.
+class MazeCanvas {
+public:
+  virtual ~MazeCanvas() = default;
+  virtual bool isOpen(int x, int y) const = 0;
+  virtual void open(int x, int y) = 0;
+  // open() may run on several threads at once for distinct cells.
+  virtual bool allowsConcurrentOpen() const { return false; }
+};
+
+// Canvas over rows of characters: '#' for wall, ' ' for open.
+class StringMazeCanvas : public MazeCanvas {
+  std::vector<std::string> &rows;
+
+public:
+  explicit StringMazeCanvas(std::vector<std::string> &_rows) : rows(_rows) {}
+  bool isOpen(int x, int y) const override { return rows[y][x] != '#'; }
+  void open(int x, int y) override { rows[y][x] = ' '; }
+  // Distinct characters are distinct memory locations
+  bool allowsConcurrentOpen() const override { return true; }
+};
+
 class MazeGenerator {
   /**
    * @brief Generates a maze using the recursive backtracking algorithm.
@@ -42,12 +86,21 @@ private:
   unsigned int width;
   unsigned int height;
   MazeGeneratorAlgorithm algorithm;
+  std::uint32_t seed;
+  // Threads BSP generation may build subtrees on; 1 builds serially.
+  unsigned int threads;
+  // Only filled when generating into the generator's own rows.
   std::vector<std::string> maze;
+  std::unique_ptr<MazeCanvas> ownCanvas;
+  MazeCanvas *canvas = nullptr;
   std::pair<unsigned int, unsigned int> start;
   std::pair<unsigned int, unsigned int> end;
+  MazeRoomGraph roomGraph;
 
   std::vector<std::pair<unsigned int, unsigned int>>
   getNeighbors(unsigned int x, unsigned int y) const;
+  void generate(int width, int height, MazeGeneratorAlgorithm algorithm,
+                MazeCanvas &output);
   void generateRecursiveDFS();
   void generateRandomizedPrim();
   void generateBSP();
@@ -55,24 +108,53 @@ private:
   // BSP helper structures and methods
   struct BSPNode {
     int x, y, width, height;
-    BSPNode* left = nullptr;
-    BSPNode* right = nullptr;
+    int left = -1;  // Into bspTree, -1 for a leaf
+    int right = -1;
     int roomX, roomY, roomW, roomH;
+    int centerX, centerY; // Of the room, set with it
     bool hasRoom = false;
+    int roomIndex = -1;     // Into roomGraph.rooms
+    int firstRoom = -1;     // Node of the subtree's leftmost room
+    std::uint32_t seed = 0; // Of this node's own random streams
   };
-  
-  void splitBSP(BSPNode* node, int depth, std::default_random_engine& rng);
-  void createRooms(BSPNode* node, std::default_random_engine& rng);
-  void connectRooms(BSPNode* node, std::default_random_engine& rng);
-  std::pair<int, int> getRoomCenter(BSPNode* node);
-  std::pair<int, int> getRoomEdge(BSPNode* node, int dirX, int dirY);
+  static constexpr int bspMaxDepth = 7;
+  // Every node the BSP tree can grow, laid out as a binary heap: node i
+  // splits into 2i + 1 and 2i + 2. Slots are fixed before the split, so
+  // subtrees built on different threads never allocate or move nodes, and
+  // index order is breadth-first order. Reset per level and kept after.
+  std::vector<BSPNode> bspTree;
+
+  // Splits and places rooms below `node`, handing subtrees above
+  // taskDepth to other threads.
+  void buildSubtree(int node, int depth, int taskDepth, bool carve);
+  void splitBSP(int node, int depth);
+  void createRoom(BSPNode &node);
+  void carveRoom(const BSPNode &node);
+  void indexRooms(bool carve);
+  void connectRooms();
+  std::pair<int, int> getRoomCenter(int node) const;
   void carveHorizontalCorridor(int x1, int x2, int y);
   void carveVerticalCorridor(int y1, int y2, int x);
 
 public:
-  MazeGenerator(int width, int height, MazeGeneratorAlgorithm algorithm);
-  std::vector<std::string> getMaze();
+  // With more than one thread, BSP generation builds independent subtrees
+  // in parallel; the maze is the same whatever the thread count.
+  MazeGenerator(int width, int height, MazeGeneratorAlgorithm algorithm,
+                std::uint32_t seed = std::random_device{}(),
+                unsigned int threads = 1);
+  // Carves into `output` instead; it must cover width x height cells, all
+  // wall, and outlive the constructor call.
+  MazeGenerator(int width, int height, MazeGeneratorAlgorithm algorithm,
+                MazeCanvas &output, std::uint32_t seed,
+                unsigned int threads = 1);
+  // The canvas may point into this generator's own rows
+  MazeGenerator(const MazeGenerator &) = delete;
+  MazeGenerator &operator=(const MazeGenerator &) = delete;
+  // Empty when generated into a caller's canvas.
+  const std::vector<std::string> &getMaze() const;
   std::pair<unsigned int, unsigned int> getStart();
   std::pair<unsigned int, unsigned int> getEnd();
+  // Empty for algorithms that do not build rooms.
+  const MazeRoomGraph &getRoomGraph() const;
 };
 #endif // MAZE_GENERATOR_H
@@ -29,7 +29,6 @@ enum class MainMenuOptions { START_GAME = '1', OPTIONS = '2', QUIT = '3' };
 void MainMenuStateHandler::handleState(Controller &controller) {
   Renderer &renderer = controller.renderer;
   renderer.setState(GameState::MAIN_MENU);
-  std::vector<std::vector<CellType>> emptyGrid;
   std::unordered_map<std::string, std::string> emptyStats;
   Point emptyPos;
 
@@ -43,7 +42,8 @@ void MainMenuStateHandler::handleState(Controller &controller) {
     menuOptions.addMessage({option.second}); // put the option into a vector
   }
 
-  renderer.draw(RendererData(emptyGrid, menuOptions, emptyStats, emptyPos));
+  renderer.draw(RendererData(nullptr, nullptr, menuOptions, emptyStats,
+                             emptyPos));
 }
 
 void MainMenuStateHandler::handleInput(Controller &controller, int ch) {
@@ -72,7 +72,10 @@ void GameplayStateHandler::handleState(Controller &controller) {
   auto stat = model.getPlayerStats();
   renderer.setState(GameState::GAMEPLAY);
   renderer.draw(
-      RendererData(model.map->grid, *model.info, stat, model.player->position, &model.activeSpellEffects, &model.traps));
+      RendererData(&model.map->terrainLayer(), &model.map->occupancyLayer(),
+                   *model.info, stat, model.player->position,
+                   &model.activeSpellEffects, &model.traps,
+                   model.playerView.get()));
 
   if (model.isGameOver()) {
     controller.setState(GameState::GAME_OVER);
@@ -160,7 +163,8 @@ void GameOverStateHandler::handleState(Controller &controller) {
   Renderer &renderer = controller.renderer;
   renderer.setState(GameState::GAME_OVER);
   renderer.draw(
-      RendererData(model.map->grid, *model.info, stat, model.player->position));
+      RendererData(&model.map->terrainLayer(), &model.map->occupancyLayer(),
+                   *model.info, stat, model.player->position));
 }
 
 void GameOverStateHandler::handleInput(Controller &controller, int ch) {
@@ -0,0 +1,77 @@
+#include "cell_layer.h"
+#include <cstring>
+
+namespace {
+// Dense rows are padded to a whole number of cache lines.
+constexpr std::size_t rowAlignment = 64;
+
+std::size_t alignedStride(unsigned int width) {
+  return (width + rowAlignment - 1) / rowAlignment * rowAlignment;
+}
+
+bool useDenseStorage(unsigned int width, unsigned int height,
+                     MapStorage storage) {
+  if (storage == MapStorage::Auto) {
+    return static_cast<std::size_t>(width) * height <=
+           CellLayer::chunkedThreshold;
+  }
+  return storage == MapStorage::Dense;
+}
+} // namespace
+
+CellLayer::CellLayer(unsigned int _width, unsigned int _height,
+                     MapStorage storage, CellType fillValue)
+    : width(_width), height(_height),
+      dense(useDenseStorage(_width, _height, storage)),
+      stride(dense ? alignedStride(_width) : Chunks::chunkSize) {
+  fill(fillValue);
+}
+
+void CellLayer::fill(CellType value) {
+  fillValue = value;
+  if (dense) {
+    cells.assign(stride * height, value);
+  } else {
+    chunks.reset(width, height, value);
+  }
+}
+
+void CellLayer::assign(GridView<const CellType> source, CellType background) {
+  fillValue = background;
+  if (dense) {
+    for (unsigned int y = 0; y < height; ++y) {
+      std::memcpy(cells.data() + static_cast<std::size_t>(y) * stride,
+                  source.row(y), width * sizeof(CellType));
+    }
+    return;
+  }
+  chunks.reset(width, height, background);
+  for (unsigned int y = 0; y < height; ++y) {
+    const CellType *row = source.row(y);
+    for (unsigned int x = 0; x < width; ++x) {
+      chunks.set(x, y, row[x]);
+    }
+  }
+}
+
+std::size_t CellLayer::memoryUsage() const {
+  return dense ? cells.size() * sizeof(CellType) : chunks.memoryUsage();
+}
+
+GridView<const CellType> CellLayer::view() const {
+  if (!dense) {
+    return {};
+  }
+  return GridView<const CellType>(cells.data(), width, height, stride);
+}
+
+GridView<const CellType> CellLayer::regionView(int left, int top,
+                                               unsigned int regionWidth,
+                                               unsigned int regionHeight) const {
+  if (!dense) {
+    return chunks.regionView(left, top, regionWidth, regionHeight);
+  }
+  return GridView<const CellType>(
+      cells.data() + static_cast<std::size_t>(top) * stride + left,
+      regionWidth, regionHeight, stride);
+}
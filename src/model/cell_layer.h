@@ -0,0 +1,115 @@
+#ifndef CELL_LAYER_H
+#define CELL_LAYER_H
+
+#include "utils/aligned_buffer.h"
+#include "utils/chunked_grid.h"
+#include "utils/game_settings.h"
+#include "utils/grid_view.h"
+#include <algorithm>
+#include <cstddef>
+
+enum class MapStorage {
+  Auto,    // Dense up to chunkedThreshold cells, chunked above it
+  Dense,   // One row-major, cache-line aligned buffer
+  Chunked  // 64x64 chunks allocated on first write
+};
+
+// One byte-per-cell layer of the map. Small levels keep a flat buffer so
+// lookups are a single indexed load; very large levels switch to sparse
+// chunks so memory follows the carved area instead of the bounding box.
+class CellLayer {
+public:
+  using Chunks = ChunkedGrid<CellType, 6>;
+  static constexpr std::size_t chunkedThreshold = std::size_t(1) << 22;
+
+  CellLayer(unsigned int width, unsigned int height, MapStorage storage,
+            CellType fillValue);
+
+  CellType get(int x, int y) const {
+    return dense ? cells[static_cast<std::size_t>(y) * stride + x]
+                 : chunks.get(x, y);
+  }
+  CellType operator()(int x, int y) const { return get(x, y); }
+
+  void set(int x, int y, CellType value) {
+    if (dense) {
+      cells[static_cast<std::size_t>(y) * stride + x] = value;
+    } else {
+      chunks.set(x, y, value);
+    }
+  }
+
+  void fill(CellType value);
+  // Copies a grid of the same size into the layer. Dense layers copy whole
+  // rows; chunked layers only allocate chunks that differ from `background`.
+  void assign(GridView<const CellType> source, CellType background);
+
+  unsigned int getWidth() const { return width; }
+  unsigned int getHeight() const { return height; }
+  // Value of the last fill() or assign() background. Chunked layers only
+  // allocate chunks holding something else.
+  CellType getFillValue() const { return fillValue; }
+  // Distance between rows of the views this layer hands out.
+  std::size_t getStride() const { return stride; }
+  bool isDense() const { return dense; }
+  std::size_t memoryUsage() const;
+
+  // Whole-layer view; empty when the layer is chunked.
+  GridView<const CellType> view() const;
+
+  // View of a rectangle that lies inside a single chunk (any rectangle when
+  // the layer is dense). Two layers of the same size share chunk borders,
+  // so a rectangle handed out by one layer's forEachChunk is valid here.
+  GridView<const CellType> regionView(int left, int top,
+                                      unsigned int regionWidth,
+                                      unsigned int regionHeight) const;
+
+  // Calls fn(originX, originY, view) for each chunk-sized piece of the
+  // rectangle. A dense layer yields the whole clipped rectangle at once.
+  template <typename Fn>
+  void forEachChunk(int left, int top, unsigned int regionWidth,
+                    unsigned int regionHeight, Fn &&fn) const {
+    if (!dense) {
+      chunks.forEachChunk(left, top, regionWidth, regionHeight, fn);
+      return;
+    }
+    const int right = std::min<int>(left + regionWidth, width);
+    const int bottom = std::min<int>(top + regionHeight, height);
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    if (left < right && top < bottom) {
+      fn(left, top, regionView(left, top, right - left, bottom - top));
+    }
+  }
+
+  // Visits only chunks that differ from the fill value somewhere; for a
+  // dense layer that is the whole layer.
+  template <typename Fn> void forEachOwnedChunk(Fn &&fn) const {
+    if (!dense) {
+      chunks.forEachOwnedChunk(fn);
+      return;
+    }
+    forEachChunk(0, 0, width, height, fn);
+  }
+
+  // Row y in pieces, left to right, skipping chunks that still share the
+  // fill value; a dense layer yields the whole row.
+  template <typename Fn> void forEachOwnedSpanInRow(int y, Fn &&fn) const {
+    if (!dense) {
+      chunks.forEachOwnedSpanInRow(y, fn);
+      return;
+    }
+    fn(0, regionView(0, y, width, 1));
+  }
+
+private:
+  unsigned int width;
+  unsigned int height;
+  bool dense;
+  std::size_t stride;
+  CellType fillValue;
+  AlignedBuffer<CellType> cells;
+  Chunks chunks;
+};
+
+#endif // CELL_LAYER_H
@@ -1,9 +1,8 @@
 #include "entity.h"
 
-Entity::Entity() : underlyingCell(CellType::FLOOR) {}
+Entity::Entity() : cellType(CellType::EMPTY) {}
 
 Entity::Entity(const Point &_position, CellType _cellType)
-    : position(_position), cellType(_cellType),
-      underlyingCell(CellType::FLOOR) {}
+    : position(_position), cellType(_cellType) {}
 
 Entity::~Entity() {}
@@ -19,7 +19,6 @@ public:
   // data
   Point position;
   CellType cellType;
-  CellType underlyingCell;
 };
 
 #endif // ENTITY_H
@@ -1,8 +1,5 @@
 #include "monster.h"
-#include "algorithms/a_star.h"
 #include "utils/global_config.h"
-#include <chrono>
-#include <future>
 #include <random>
 
 std::unordered_map<CellType, int> monsterExpMap = {{CellType::GOBLIN, 100},
@@ -11,22 +8,48 @@ std::unordered_map<CellType, int> monsterExpMap = {{CellType::GOBLIN, 100},
                                                    {CellType::TROLL, 400},
                                                    {CellType::SKELETON, 150}};
 
-std::mt19937 generateSeededRNG() {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  return gen;
-}
+// Half the side of an Orc's pursuit window, in follow ranges: the chase
+// starts within one, leaving room for detours and for both sides to move.
+constexpr int pursuitWindowRanges = 3;
 
 Monster::Monster(CellType cellType, int _health, int _attack)
     : MovableEntity(cellType, _health, _attack) {}
 
+void Monster::setChaseField(std::shared_ptr<const DistanceField> field) {
+  chaseField = std::move(field);
+}
+
+void Monster::setSight(std::shared_ptr<const FieldOfView> field) {
+  sight = std::move(field);
+}
+
+void Monster::setRng(std::mt19937 generator) { rng = generator; }
+
+bool Monster::seesPlayer(const Point &target, int range) const {
+  return position.distance(target) <= range &&
+         (!sight || sight->isVisible(position));
+}
+
+bool Monster::followChaseField(int followRange) {
+  // The field leads around walls, but only toward a player in sight
+  if (!seesPlayer(chaseField->getSource(), followRange)) {
+    return false;
+  }
+  const int distance = chaseField->distanceAt(position);
+  if (distance == DistanceField::unreached || distance == 0 ||
+      distance > followRange) {
+    return false;
+  }
+  velocity = chaseField->descend(position);
+  return true;
+}
+
 void Monster::randomizeVelocity() {
-  static std::mt19937 gen = generateSeededRNG();
   std::uniform_int_distribution<> distrib(-1, 1);
 
   do {
-    velocity.x = distrib(gen);
-    velocity.y = distrib(gen);
+    velocity.x = distrib(rng);
+    velocity.y = distrib(rng);
   } while (velocity.x == 0 && velocity.y == 0);
 }
 
@@ -38,8 +61,15 @@ Goblin::Goblin(std::shared_ptr<Map> _map, std::shared_ptr<Player> _player)
       followRange(GlobalConfig::getInstance().getConfig<int>("GoblinFollowRange")) {}
 
 void Goblin::randomizeVelocity() {
+  if (chaseField) {
+    if (!followChaseField(followRange)) {
+      Monster::randomizeVelocity();
+    }
+    return;
+  }
+
   // Check if player is within follow range
-  if (position.distance(player->position) <= followRange) {
+  if (seesPlayer(player->position, followRange)) {
     // Move towards player (simple direct approach)
     Point diff = player->position - position;
     velocity.x = (diff.x > 0) ? 1 : (diff.x < 0) ? -1 : 0;
@@ -61,16 +91,22 @@ void Goblin::move(const Point &destination) {
 }
 
 std::string Goblin::toString() const { return "Goblin"; }
-Orc::Orc(std::shared_ptr<Map> _map, std::shared_ptr<Player> _player)
+Orc::Orc(std::shared_ptr<Map> _map, std::shared_ptr<Player> _player,
+         std::shared_ptr<PathService> _pathService)
     : Monster(CellType::ORC,
               GlobalConfig::getInstance().getConfig<int>("OrcHealth"),
               GlobalConfig::getInstance().getConfig<int>("OrcDamage")),
       map(std::move(_map)), player(std::move(_player)),
-      followRange(GlobalConfig::getInstance().getConfig<int>("OrcFollowRange")),
-      pathCalculating(false) {}
+      pathService(std::move(_pathService)),
+      followRange(GlobalConfig::getInstance().getConfig<int>("OrcFollowRange")) {}
+
+Orc::~Orc() {
+  if (terrainSubscription >= 0) {
+    map->unsubscribe(terrainSubscription);
+  }
+}
 
 void Orc::move(const Point &destination) {
-  std::lock_guard<std::mutex> lock(mutex);
   MovableEntity::move(destination);
 
   if (position.distance(player->position) < 5) {
@@ -79,25 +115,16 @@ void Orc::move(const Point &destination) {
 }
 
 Point Orc::getVelocity() {
-  std::lock_guard<std::mutex> lock(mutex);
-  
-  // Check if pathfinding is complete
-  if (pathCalculating && pathFuture.valid()) {
-    // Non-blocking check if pathfinding is done
-    if (pathFuture.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
-      try {
-        path = pathFuture.get();
-        if (!path.empty()) {
-          path.pop_front();
-        }
-        pathCalculating = false;
-      } catch (const std::system_error &e) {
-        std::cerr << "Orc pathfinding error: " << e.what() << '\n';
-        pathCalculating = false;
-      }
+  // Paths arrive between ticks, when the service delivers them
+  if (pathRequest && pathRequest->ready) {
+    path = std::move(pathRequest->path);
+    pursuitFellShort = pursuing && path.empty();
+    if (!path.empty()) {
+      path.pop_front();
     }
+    pathRequest.reset();
   }
-  
+
   if (!path.empty()) {
     auto newPos = path.front();
     path.pop_front();
@@ -110,8 +137,8 @@ Point Orc::getVelocity() {
 std::string Orc::toString() const { return "Orc"; }
 
 void Orc::randomizeVelocity() {
-  // Don't start a new pathfinding if one is already in progress
-  if (pathCalculating) {
+  // Don't ask for another path while one is on its way
+  if (pathRequest) {
     // Use random movement as fallback while pathfinding is in progress
     Monster::randomizeVelocity();
     return;
@@ -121,18 +148,53 @@ void Orc::randomizeVelocity() {
     return;
   }
 
-  auto isNavigable = [](const CellType &cell) {
-    return cell == CellType::EMPTY || cell == CellType::PLAYER;
-  };
+  // Close enough to walk down the shared field; only detours longer than
+  // the field's reach need a search of their own
+  if (chaseField && followChaseField(followRange)) {
+    path.clear();
+    return;
+  }
 
-  // Start pathfinding asynchronously without blocking
-  // Capture necessary values by copy to avoid race conditions
-  pathCalculating = true;
-  pathFuture = std::async(std::launch::async, 
-    [map = this->map, currentPosition = this->position, isNavigable, playerPosition = player->position]() {
-    AStar<CellType> aStar(map->grid, currentPosition, playerPosition, isNavigable);
-    return aStar.getPath();
-  });
+  // Only hunt down a player we can see; no search can reach one walled
+  // off from us
+  if (!pathService || !seesPlayer(player->position, followRange) ||
+      !map->sameComponent(position, player->position)) {
+    Monster::randomizeVelocity();
+    return;
+  }
+  if (pursuitFellShort) {
+    pursuitFellShort = false;
+    pursuing = false;
+    pathRequest = pathService->request(position, player->position);
+    return;
+  }
+  if (!pursuit) {
+    pursuit = std::make_shared<DStarLite>();
+    terrainSubscription = map->subscribe([this](const CellChange &change) {
+      if (change.layer == MapLayer::Terrain) {
+        changedTerrain.push_back(change.point);
+      }
+    });
+  }
+  if (!pursuit->covers(position) || !pursuit->covers(player->position)) {
+    // Plan only around the chase, so the state stays a few followRanges
+    // across whatever the level's size; it is copied from live terrain
+    const Point centre((position.x + player->position.x) / 2,
+                       (position.y + player->position.y) / 2);
+    pursuit->reset(map->walkableCells(), centre,
+                   pursuitWindowRanges * followRange);
+    const Point exit = map->getEnd();
+    pursuit->setNavigable(exit.x, exit.y, false);
+  } else {
+    for (const Point &cell : changedTerrain) {
+      pursuit->setNavigable(cell.x, cell.y,
+                            map->walkableCells().test(cell.x, cell.y) &&
+                                cell != map->getEnd());
+    }
+  }
+  changedTerrain.clear();
+  pursuing = true;
+  pathRequest = pathService->request(position, player->position, pursuit);
 }
 
 Troll::Troll(std::shared_ptr<Map> _map, std::shared_ptr<Player> _player)
@@ -145,8 +207,15 @@ Troll::Troll(std::shared_ptr<Map> _map, std::shared_ptr<Player> _player)
 }
 
 void Troll::randomizeVelocity() {
+  if (chaseField) {
+    if (!followChaseField(followRange)) {
+      Monster::randomizeVelocity();
+    }
+    return;
+  }
+
   // Check if player is within follow range
-  if (position.distance(player->position) <= followRange) {
+  if (seesPlayer(player->position, followRange)) {
     // Move towards player (simple direct approach)
     Point diff = player->position - position;
     velocity.x = (diff.x > 0) ? 1 : (diff.x < 0) ? -1 : 0;
@@ -196,16 +265,23 @@ Skeleton::Skeleton(std::shared_ptr<Map> _map, std::shared_ptr<Player> _player)
 }
 
 void Skeleton::randomizeVelocity() {
-  static std::mt19937 gen = generateSeededRNG();
   std::uniform_int_distribution<> followChance(0, 99);
+
+  if (chaseField) {
+    // 70% chance to follow the field, 30% random
+    if (followChance(rng) >= 70 || !followChaseField(followRange)) {
+      Monster::randomizeVelocity();
+    }
+    return;
+  }
   
   // Check if player is within follow range
-  if (position.distance(player->position) <= followRange) {
+  if (seesPlayer(player->position, followRange)) {
     // Move towards player with some randomness (erratic movement)
     Point diff = player->position - position;
     
     // 70% chance to move towards player, 30% random
-    if (followChance(gen) < 70) {
+    if (followChance(rng) < 70) {
       velocity.x = (diff.x > 0) ? 1 : (diff.x < 0) ? -1 : 0;
       velocity.y = (diff.y > 0) ? 1 : (diff.y < 0) ? -1 : 0;
       
@@ -223,12 +299,11 @@ void Skeleton::randomizeVelocity() {
 }
 
 void Skeleton::move(const Point &destination) {
-  static std::mt19937 gen = generateSeededRNG();
   std::uniform_int_distribution<> changeChance(0, 1);
   
   MovableEntity::move(destination);
   // Skeletons have a 50% chance to change direction after each move
-  if (changeChance(gen) == 0) {
+  if (changeChance(rng) == 0) {
     randomizeVelocity();
   }
 }
@@ -1,14 +1,17 @@
 #ifndef MONSTER_H
 #define MONSTER_H
 
+#include "algorithms/distance_field.h"
+#include "algorithms/field_of_view.h"
 #include "model/map.h"
+#include "model/path_service.h"
 #include "movable_entity.h"
 #include "player.h"
 #include <deque>
-#include <future>
 #include <memory>
-#include <mutex>
+#include <random>
 #include <unordered_map>
+#include <vector>
 
 extern std::unordered_map<CellType, int> monsterExpMap;
 
@@ -17,6 +20,27 @@ class Monster : public MovableEntity {
 public:
   Monster(CellType cellType, int _health, int _attack);
   virtual void randomizeVelocity();
+  // Distance field toward the player, shared by every chaser and refreshed
+  // by the Model. Without one, chasers steer straight at the player.
+  void setChaseField(std::shared_ptr<const DistanceField> field);
+  // The player's field of view, refreshed by the Model. Sight is symmetric,
+  // so it also tells whether a monster sees the player. Without one,
+  // monsters see through walls.
+  void setSight(std::shared_ptr<const FieldOfView> field);
+  // Source of every random move. The Model derives one per monster from
+  // the level's seed, so a seed replays the same fights.
+  void setRng(std::mt19937 generator);
+
+protected:
+  std::shared_ptr<const DistanceField> chaseField;
+  std::shared_ptr<const FieldOfView> sight;
+  std::mt19937 rng;
+  // The player at `target` is within `range` and in line of sight.
+  bool seesPlayer(const Point &target, int range) const;
+  // Points velocity one step down the chase field if the monster sees the
+  // player and the player is at most followRange steps away by walking.
+  // Returns false otherwise.
+  bool followChaseField(int followRange);
 };
 
 class Goblin : public Monster {
@@ -36,14 +60,34 @@ class Orc : public Monster {
 
   std::shared_ptr<Map> map;
   std::shared_ptr<Player> player;
+  // Plans longer chases off the game thread; without one, Orcs only
+  // follow the chase field.
+  std::shared_ptr<PathService> pathService;
   std::deque<Point> path;
-  std::mutex mutex;
+  // Outstanding path, cancelled when dropped.
+  std::shared_ptr<PathRequest> pathRequest;
+  // Search state of this Orc's chase, repaired by each request instead of
+  // searched from scratch. Created on the first request and confined to a
+  // window around the Orc and the player, moved when either leaves it.
+  std::shared_ptr<DStarLite> pursuit;
+  // Terrain cells written since the last request, handed to the pursuit
+  // only while no request is using it.
+  std::vector<Point> changedTerrain;
+  // pathRequest was planned by the pursuit.
+  bool pursuing = false;
+  // The pursuit's last plan came back empty, most likely because the way
+  // round leaves its window; the next request goes to the whole-level
+  // planners instead.
+  bool pursuitFellShort = false;
+  int terrainSubscription = -1;
   int followRange;
-  std::future<std::deque<Point>> pathFuture;
-  bool pathCalculating;
 
 public:
-  explicit Orc(std::shared_ptr<Map> _map, std::shared_ptr<Player> player);
+  explicit Orc(std::shared_ptr<Map> _map, std::shared_ptr<Player> player,
+               std::shared_ptr<PathService> _pathService = nullptr);
+  ~Orc() override;
+  Orc(const Orc &) = delete;
+  Orc &operator=(const Orc &) = delete;
   void move(const Point &destination) override;
   std::string toString() const override;
   void randomizeVelocity() override;
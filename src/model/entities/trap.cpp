@@ -210,6 +210,8 @@ ArrowTrap::ArrowTrap(const Point &position, Point direction)
 
 ArrowTrap::~ArrowTrap() {}
 
+Point ArrowTrap::getDirection() const { return shootDirection; }
+
 void ArrowTrap::update() {
   switch (state) {
     case TrapState::INACTIVE:
@@ -90,6 +90,8 @@ private:
 public:
   explicit ArrowTrap(const Point &position, Point direction);
   ~ArrowTrap() override;
+
+  Point getDirection() const;
   
   void update() override;
   void activate() override;
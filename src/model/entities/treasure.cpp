@@ -48,6 +48,8 @@ BonusType Treasure::getBonusType() const { return bonusType; }
 
 void Treasure::setBonusType(BonusType _bonusType) { bonusType = _bonusType; }
 
+int Treasure::getExpirationCounter() const { return expirationCounter; }
+
 bool Treasure::isExpired() const { return expirationCounter <= 0; }
 
 void Treasure::decrementExpirationCounter() { --expirationCounter; }
@@ -23,6 +23,7 @@ public:
   BonusType getBonusType() const;
   void setBonusType(BonusType _bonusType);
 
+  int getExpirationCounter() const;
   bool isExpired() const;
   void decrementExpirationCounter();
 
@@ -0,0 +1,45 @@
+#include "level_cache.h"
+
+LevelCache::LevelCache(std::size_t capacity) : capacity(capacity) {}
+
+std::shared_ptr<const TerrainSnapshot>
+LevelCache::find(const LevelKey &key) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = index.find(key);
+  if (it == index.end()) {
+    return nullptr;
+  }
+  entries.splice(entries.begin(), entries, it->second);
+  ++hits;
+  return it->second->second;
+}
+
+void LevelCache::insert(const LevelKey &key,
+                        std::shared_ptr<const TerrainSnapshot> snapshot) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (capacity == 0) {
+    return;
+  }
+  auto it = index.find(key);
+  if (it != index.end()) {
+    it->second->second = std::move(snapshot);
+    entries.splice(entries.begin(), entries, it->second);
+    return;
+  }
+  if (entries.size() == capacity) {
+    index.erase(entries.back().first);
+    entries.pop_back();
+  }
+  entries.emplace_front(key, std::move(snapshot));
+  index.emplace(key, entries.begin());
+}
+
+std::size_t LevelCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+std::size_t LevelCache::hitCount() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return hits;
+}
@@ -0,0 +1,66 @@
+#ifndef LEVEL_CACHE_H
+#define LEVEL_CACHE_H
+
+#include "algorithms/maze_generator.h"
+#include "map.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+// Everything that decides what a generated level looks like.
+struct LevelKey {
+  std::uint32_t seed = 0;
+  unsigned int width = 0;
+  unsigned int height = 0;
+  MazeGeneratorAlgorithm algorithm = MazeGeneratorAlgorithm::BSP;
+
+  bool operator==(const LevelKey &other) const {
+    return seed == other.seed && width == other.width &&
+           height == other.height && algorithm == other.algorithm;
+  }
+  bool operator!=(const LevelKey &other) const { return !(*this == other); }
+};
+
+struct LevelKeyHash {
+  std::size_t operator()(const LevelKey &key) const {
+    std::size_t hash = key.seed;
+    hash = hash * 31 + key.width;
+    hash = hash * 31 + key.height;
+    return hash * 31 + static_cast<std::size_t>(key.algorithm);
+  }
+};
+
+// Recently generated levels, least recently used evicted first. Restoring
+// a snapshot skips generation entirely, so replaying a seed (a restart, a
+// benchmark rerun) costs a copy of the terrain. Safe to share between
+// threads.
+class LevelCache {
+public:
+  explicit LevelCache(std::size_t capacity = 8);
+
+  // The level generated for `key`, if still cached; counts as a use.
+  std::shared_ptr<const TerrainSnapshot> find(const LevelKey &key);
+  void insert(const LevelKey &key,
+              std::shared_ptr<const TerrainSnapshot> snapshot);
+
+  std::size_t size() const;
+  std::size_t getCapacity() const { return capacity; }
+  std::size_t hitCount() const;
+
+private:
+  using Entry = std::pair<LevelKey, std::shared_ptr<const TerrainSnapshot>>;
+
+  std::size_t capacity;
+  std::size_t hits = 0;
+  // Most recently used first
+  std::list<Entry> entries;
+  std::unordered_map<LevelKey, std::list<Entry>::iterator, LevelKeyHash>
+      index;
+  mutable std::mutex mutex;
+};
+
+#endif // LEVEL_CACHE_H
@@ -0,0 +1,252 @@
+#include "level_file.h"
+#include "utils/cell_traits.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr char levelFileMagic[4] = {'A', 'Q', 'L', 'V'};
+
+std::size_t alignTo4(std::size_t offset) { return (offset + 3) & ~std::size_t(3); }
+
+std::size_t cellBytes(const LevelFileHeader &header) {
+  return static_cast<std::size_t>(header.width) * header.height;
+}
+
+std::size_t recordsOffsetOf(const LevelFileHeader &header) {
+  return alignTo4(sizeof(LevelFileHeader) + 2 * cellBytes(header));
+}
+
+std::size_t expectedSize(const LevelFileHeader &header) {
+  return recordsOffsetOf(header) +
+         header.monsterCount * sizeof(MonsterRecord) +
+         header.treasureCount * sizeof(TreasureRecord) +
+         header.potionCount * sizeof(PotionRecord) +
+         header.trapCount * sizeof(TrapRecord) +
+         header.movableCount * sizeof(MovableRecord);
+}
+
+void writeLayer(std::ofstream &out, const CellLayer &layer) {
+  std::vector<CellType> row(layer.getWidth());
+  for (int y = 0; y < static_cast<int>(layer.getHeight()); ++y) {
+    layer.forEachChunk(0, y, layer.getWidth(), 1,
+                       [&row](int originX, int, GridView<const CellType> part) {
+                         std::memcpy(row.data() + originX, part.row(0),
+                                     part.getWidth());
+                       });
+    out.write(reinterpret_cast<const char *>(row.data()), row.size());
+  }
+}
+
+bool isCellType(CellType type) {
+  return static_cast<std::size_t>(type) < cellTypeCount;
+}
+
+bool holdsOnlyCellTypes(GridView<const CellType> cells) {
+  for (unsigned int y = 0; y < cells.getHeight(); ++y) {
+    const CellType *row = cells.row(y);
+    if (!std::all_of(row, row + cells.getWidth(), isCellType)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename Record>
+void writeRecords(std::ofstream &out, const std::vector<Record> &records) {
+  out.write(reinterpret_cast<const char *>(records.data()),
+            records.size() * sizeof(Record));
+}
+} // namespace
+
+LevelFile::LevelFile(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0 ||
+      static_cast<std::size_t>(info.st_size) < sizeof(LevelFileHeader)) {
+    ::close(fd);
+    return;
+  }
+  void *mapping = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // The mapping stays valid after the descriptor is closed
+  if (mapping == MAP_FAILED) {
+    return;
+  }
+  data = static_cast<const unsigned char *>(mapping);
+  size = static_cast<std::size_t>(info.st_size);
+
+  const LevelFileHeader &fileHeader = header();
+  if (std::memcmp(fileHeader.magic, levelFileMagic, sizeof(levelFileMagic)) !=
+          0 ||
+      fileHeader.version != levelFileVersion || fileHeader.width == 0 ||
+      fileHeader.height == 0 || size < expectedSize(fileHeader)) {
+    close();
+    return;
+  }
+  recordsOffset = recordsOffsetOf(fileHeader);
+  if (!isWellFormed()) {
+    close();
+  }
+}
+
+void LevelFile::close() {
+  ::munmap(const_cast<unsigned char *>(data), size);
+  data = nullptr;
+  size = 0;
+  recordsOffset = 0;
+}
+
+bool LevelFile::isWellFormed() const {
+  const LevelFileHeader &fileHeader = header();
+  auto inside = [&fileHeader](std::int32_t x, std::int32_t y) {
+    return x >= 0 && y >= 0 &&
+           static_cast<std::uint32_t>(x) < fileHeader.width &&
+           static_cast<std::uint32_t>(y) < fileHeader.height;
+  };
+  if (!inside(fileHeader.startX, fileHeader.startY) ||
+      !inside(fileHeader.endX, fileHeader.endY) ||
+      !inside(fileHeader.playerX, fileHeader.playerY)) {
+    return false;
+  }
+  // Cell bytes index per-type tables all over the game
+  if (!holdsOnlyCellTypes(terrain()) || !holdsOnlyCellTypes(occupants())) {
+    return false;
+  }
+  // Each record must sit on the occupant cell that draws it, or the game
+  // would index an entity the map does not show
+  auto occupiedBy = [this, &inside](std::int32_t x, std::int32_t y,
+                                    CellType type) {
+    return inside(x, y) && occupants()(x, y) == type;
+  };
+  for (const auto &record : monsters()) {
+    if (!isCellType(record.type) ||
+        !hasTrait(record.type, CellTrait::Monster) ||
+        !occupiedBy(record.x, record.y, record.type)) {
+      return false;
+    }
+  }
+  for (const auto &record : treasures()) {
+    if (!occupiedBy(record.x, record.y, CellType::TREASURE)) {
+      return false;
+    }
+  }
+  for (const auto &record : potions()) {
+    if (!occupiedBy(record.x, record.y, CellType::POTION)) {
+      return false;
+    }
+  }
+  // Traps live on the terrain and leave the occupant layer alone
+  for (const auto &record : traps()) {
+    if (!inside(record.x, record.y)) {
+      return false;
+    }
+  }
+  for (const auto &record : movables()) {
+    if (!isCellType(record.type) ||
+        !hasTrait(record.type, CellTrait::Movable) ||
+        !occupiedBy(record.x, record.y, record.type)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+LevelFile::~LevelFile() {
+  if (data != nullptr) {
+    ::munmap(const_cast<unsigned char *>(data), size);
+  }
+}
+
+bool LevelFile::isOpen() const { return data != nullptr; }
+
+const LevelFileHeader &LevelFile::header() const {
+  return *reinterpret_cast<const LevelFileHeader *>(data);
+}
+
+GridView<const CellType> LevelFile::terrain() const {
+  const LevelFileHeader &fileHeader = header();
+  return GridView<const CellType>(
+      reinterpret_cast<const CellType *>(data + sizeof(LevelFileHeader)),
+      fileHeader.width, fileHeader.height, fileHeader.width);
+}
+
+GridView<const CellType> LevelFile::occupants() const {
+  const LevelFileHeader &fileHeader = header();
+  return GridView<const CellType>(
+      reinterpret_cast<const CellType *>(data + sizeof(LevelFileHeader) +
+                                         cellBytes(fileHeader)),
+      fileHeader.width, fileHeader.height, fileHeader.width);
+}
+
+template <typename Record>
+RecordTable<Record> LevelFile::table(std::size_t offset,
+                                     std::uint32_t count) const {
+  return RecordTable<Record>{
+      reinterpret_cast<const Record *>(data + offset), count};
+}
+
+RecordTable<MonsterRecord> LevelFile::monsters() const {
+  return table<MonsterRecord>(recordsOffset, header().monsterCount);
+}
+
+RecordTable<TreasureRecord> LevelFile::treasures() const {
+  const std::size_t offset =
+      recordsOffset + header().monsterCount * sizeof(MonsterRecord);
+  return table<TreasureRecord>(offset, header().treasureCount);
+}
+
+RecordTable<PotionRecord> LevelFile::potions() const {
+  const std::size_t offset = reinterpret_cast<const unsigned char *>(
+                                 treasures().end()) - data;
+  return table<PotionRecord>(offset, header().potionCount);
+}
+
+RecordTable<TrapRecord> LevelFile::traps() const {
+  const std::size_t offset =
+      reinterpret_cast<const unsigned char *>(potions().end()) - data;
+  return table<TrapRecord>(offset, header().trapCount);
+}
+
+RecordTable<MovableRecord> LevelFile::movables() const {
+  const std::size_t offset =
+      reinterpret_cast<const unsigned char *>(traps().end()) - data;
+  return table<MovableRecord>(offset, header().movableCount);
+}
+
+bool LevelFile::write(const std::string &path, LevelFileHeader header,
+                      const CellLayer &terrain, const CellLayer &occupants,
+                      const LevelRecords &records) {
+  std::memcpy(header.magic, levelFileMagic, sizeof(levelFileMagic));
+  header.version = levelFileVersion;
+  header.width = terrain.getWidth();
+  header.height = terrain.getHeight();
+  header.monsterCount = records.monsters.size();
+  header.treasureCount = records.treasures.size();
+  header.potionCount = records.potions.size();
+  header.trapCount = records.traps.size();
+  header.movableCount = records.movables.size();
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return false;
+  }
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  writeLayer(out, terrain);
+  writeLayer(out, occupants);
+  const char padding[4] = {};
+  const std::size_t written = sizeof(header) + 2 * cellBytes(header);
+  out.write(padding, recordsOffsetOf(header) - written);
+  writeRecords(out, records.monsters);
+  writeRecords(out, records.treasures);
+  writeRecords(out, records.potions);
+  writeRecords(out, records.traps);
+  writeRecords(out, records.movables);
+  return static_cast<bool>(out);
+}
@@ -0,0 +1,137 @@
+#ifndef LEVEL_FILE_H
+#define LEVEL_FILE_H
+
+#include "cell_layer.h"
+#include "utils/game_settings.h"
+#include "utils/grid_view.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary level format, native byte order:
+//
+//   LevelFileHeader
+//   terrain cells    width * height bytes, row-major
+//   occupant cells   width * height bytes, row-major
+//   padding          up to a 4-byte boundary
+//   MonsterRecord[monsterCount], TreasureRecord[treasureCount],
+//   PotionRecord[potionCount], TrapRecord[trapCount],
+//   MovableRecord[movableCount]
+//
+// Every record is a fixed-size POD so a mapped file is used in place.
+// Bump levelFileVersion whenever any of these layouts change.
+constexpr std::uint32_t levelFileVersion = 1;
+
+struct LevelFileHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t width;
+  std::uint32_t height;
+  std::int32_t startX, startY;
+  std::int32_t endX, endY;
+  std::int32_t playerX, playerY;
+  std::int32_t level;
+  std::uint32_t monsterCount;
+  std::uint32_t treasureCount;
+  std::uint32_t potionCount;
+  std::uint32_t trapCount;
+  std::uint32_t movableCount;
+};
+
+struct MonsterRecord {
+  std::int32_t x, y;
+  std::int32_t health;
+  std::int32_t strength;
+  CellType type;
+  std::uint8_t padding[3];
+};
+
+struct TreasureRecord {
+  std::int32_t x, y;
+  std::int32_t value;
+  std::int32_t expirationCounter;
+  std::uint8_t bonusType;
+  std::uint8_t padding[3];
+};
+
+struct PotionRecord {
+  std::int32_t x, y;
+  std::uint8_t potionType;
+  std::uint8_t padding[3];
+};
+
+struct TrapRecord {
+  std::int32_t x, y;
+  std::int32_t directionX, directionY;
+  std::uint8_t trapType;
+  std::uint8_t padding[3];
+};
+
+struct MovableRecord {
+  std::int32_t x, y;
+  CellType type;
+  std::uint8_t padding[3];
+};
+
+// Read-only view of a fixed-size record table inside a mapped file.
+template <typename Record> struct RecordTable {
+  const Record *records = nullptr;
+  std::size_t count = 0;
+
+  const Record *begin() const { return records; }
+  const Record *end() const { return records + count; }
+  std::size_t size() const { return count; }
+};
+
+// Everything needed to write a level back out.
+struct LevelRecords {
+  std::vector<MonsterRecord> monsters;
+  std::vector<TreasureRecord> treasures;
+  std::vector<PotionRecord> potions;
+  std::vector<TrapRecord> traps;
+  std::vector<MovableRecord> movables;
+};
+
+// A level file mapped read-only into memory. Accessors point straight into
+// the mapping, so the LevelFile must outlive anything read through them.
+class LevelFile {
+public:
+  // isOpen() is false if the file is missing, truncated, or written by
+  // another format version, if any cell byte is not a CellType, any
+  // position lies outside the level, or a monster, treasure, potion or
+  // movable record does not match the occupant cell it sits on. Bonus,
+  // potion and trap kinds are checked by the loader, which owns those enums.
+  explicit LevelFile(const std::string &path);
+  ~LevelFile();
+  LevelFile(const LevelFile &) = delete;
+  LevelFile &operator=(const LevelFile &) = delete;
+
+  bool isOpen() const;
+  const LevelFileHeader &header() const;
+  GridView<const CellType> terrain() const;
+  GridView<const CellType> occupants() const;
+  RecordTable<MonsterRecord> monsters() const;
+  RecordTable<TreasureRecord> treasures() const;
+  RecordTable<PotionRecord> potions() const;
+  RecordTable<TrapRecord> traps() const;
+  RecordTable<MovableRecord> movables() const;
+
+  // Fills in magic, version, size and record counts of `header` and writes
+  // the whole file. Returns false on any I/O error.
+  static bool write(const std::string &path, LevelFileHeader header,
+                    const CellLayer &terrain, const CellLayer &occupants,
+                    const LevelRecords &records);
+
+private:
+  const unsigned char *data = nullptr;
+  std::size_t size = 0;
+  std::size_t recordsOffset = 0;
+
+  void close();
+  bool isWellFormed() const;
+  template <typename Record>
+  RecordTable<Record> table(std::size_t offset, std::uint32_t count) const;
+};
+
+#endif // LEVEL_FILE_H
@@ -0,0 +1,61 @@
+#include "level_prefetcher.h"
+#include <algorithm>
+#include <chrono>
+
+LevelPrefetcher::LevelPrefetcher(std::size_t cacheCapacity)
+    : cache(cacheCapacity) {}
+
+LevelPrefetcher::~LevelPrefetcher() {
+  if (pending.valid()) {
+    pending.wait();
+  }
+  for (auto &level : abandoned) {
+    level.wait();
+  }
+}
+
+void LevelPrefetcher::prefetch(const LevelKey &key) {
+  if (pending.valid()) {
+    if (pendingKey == key) {
+      return;
+    }
+    abandonPending();
+  }
+  pendingKey = key;
+  // The destructor waits for the worker, so it may use the cache
+  pending = std::async(std::launch::async, [this, key] { return build(key); });
+}
+
+std::shared_ptr<Map> LevelPrefetcher::take(const LevelKey &key) {
+  if (pending.valid()) {
+    if (pendingKey == key) {
+      return pending.get();
+    }
+    abandonPending();
+  }
+  return build(key);
+}
+
+void LevelPrefetcher::abandonPending() {
+  abandoned.erase(
+      std::remove_if(abandoned.begin(), abandoned.end(),
+                     [](const std::future<std::shared_ptr<Map>> &level) {
+                       return level.wait_for(std::chrono::seconds(0)) ==
+                              std::future_status::ready;
+                     }),
+      abandoned.end());
+  abandoned.push_back(std::move(pending));
+}
+
+std::shared_ptr<Map> LevelPrefetcher::build(const LevelKey &key) {
+  auto map = std::make_shared<Map>(key.width, key.height);
+  if (auto snapshot = cache.find(key)) {
+    map->restoreTerrain(*snapshot);
+    return map;
+  }
+  map->loadLevel(key.seed, key.algorithm);
+  map->setCellType(map->getEnd(), CellType::END);
+  cache.insert(key, std::make_shared<const TerrainSnapshot>(
+                        map->snapshotTerrain()));
+  return map;
+}
@@ -0,0 +1,51 @@
+#ifndef LEVEL_PREFETCHER_H
+#define LEVEL_PREFETCHER_H
+
+#include "level_cache.h"
+#include "map.h"
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <vector>
+
+// Generates the next level's map on a background thread while the current
+// level is played, so reaching the exit only swaps a finished map in. The
+// map is handed over whole through a future and touched by one thread at
+// a time: the worker until take(), the game thread after.
+//
+// Levels pass through a LevelCache, so one already generated for the same
+// key is restored instead of generated again.
+class LevelPrefetcher {
+public:
+  explicit LevelPrefetcher(std::size_t cacheCapacity = 8);
+  // Waits for levels still being generated.
+  ~LevelPrefetcher();
+  LevelPrefetcher(const LevelPrefetcher &) = delete;
+  LevelPrefetcher &operator=(const LevelPrefetcher &) = delete;
+
+  // Starts generating the level for `key`, unless it is already pending.
+  // A level pending for another key is abandoned: it finishes into the
+  // cache in the background and nobody waits for it.
+  void prefetch(const LevelKey &key);
+  bool isPending() const { return pending.valid(); }
+
+  // The level for `key`: the prefetched one, waiting for it if it is not
+  // finished yet, or one restored or generated on the spot otherwise. A
+  // level pending for another key is abandoned as in prefetch().
+  std::shared_ptr<Map> take(const LevelKey &key);
+
+  const LevelCache &getCache() const { return cache; }
+
+private:
+  LevelCache cache;
+  std::future<std::shared_ptr<Map>> pending;
+  LevelKey pendingKey;
+  // Abandoned levels still generating; their futures would block if
+  // destroyed, so they are kept until ready.
+  std::vector<std::future<std::shared_ptr<Map>>> abandoned;
+
+  void abandonPending();
+  std::shared_ptr<Map> build(const LevelKey &key);
+};
+
+#endif // LEVEL_PREFETCHER_H
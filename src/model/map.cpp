@@ -1,59 +1,201 @@
 #include "map.h"
+#include "utils/cell_traits.h"
 #include <algorithm>
-#include <array>
-#include <queue>
 #include <random>
+#include <thread>
 
-Map::Map(unsigned int _width, unsigned int _height)
-    : width(_width), height(_height) {}
+namespace {
+// Below this many cells, building BSP subtrees on other threads costs more
+// than it saves.
+constexpr std::size_t parallelGenerationArea = std::size_t(1) << 20;
 
-void Map::loadLevel() {
-  MazeGenerator generator(width, height,
-                          MazeGeneratorAlgorithm::BSP);
-  auto maze = generator.getMaze();
+// Lets the generator carve straight into the terrain layer: uncarved cells
+// stay WALL, carved ones become FLOOR. A chunked layer only allocates the
+// chunks that get carved.
+class TerrainCanvas : public MazeCanvas {
+  CellLayer &terrain;
+
+public:
+  explicit TerrainCanvas(CellLayer &_terrain) : terrain(_terrain) {}
+  bool isOpen(int x, int y) const override {
+    return terrain(x, y) != CellType::WALL;
+  }
+  void open(int x, int y) override { terrain.set(x, y, CellType::FLOOR); }
+  // Chunked layers allocate chunks on first write
+  bool allowsConcurrentOpen() const override { return terrain.isDense(); }
+};
+} // namespace
+
+Map::Map(unsigned int _width, unsigned int _height, MapStorage storage)
+    : width(_width), height(_height),
+      terrain(_width, _height, storage, CellType::EMPTY),
+      occupants(_width, _height, storage, CellType::EMPTY),
+      walkable(_width, _height, hasTrait(CellType::EMPTY, CellTrait::Walkable)),
+      opaque(_width, _height, hasTrait(CellType::EMPTY, CellTrait::Opaque)),
+      pushable(_width, _height), occupied(_width, _height),
+      dirtyTiles((_width + dirtyTileSize - 1) >> dirtyTileBits,
+                 (_height + dirtyTileSize - 1) >> dirtyTileBits, true) {
+  rebuildFreeCells();
+}
+
+void Map::loadLevel() { loadLevel(std::random_device{}()); }
+
+void Map::loadLevel(std::uint32_t seed, MazeGeneratorAlgorithm algorithm) {
+  // The level is generated straight into the terrain layer; a fresh level
+  // has no occupants
+  levelSeed = seed;
+  rng.seed(seed);
+  terrain.fill(CellType::WALL);
+  TerrainCanvas canvas(terrain);
+  const unsigned int threads =
+      static_cast<std::size_t>(width) * height >= parallelGenerationArea
+          ? std::max(1u, std::thread::hardware_concurrency())
+          : 1;
+  MazeGenerator generator(width, height, algorithm, canvas, seed, threads);
 
   start = {static_cast<int>(generator.getStart().first),
            static_cast<int>(generator.getStart().second)};
   end = {static_cast<int>(generator.getEnd().first),
          static_cast<int>(generator.getEnd().second)};
 
-  // Convert maze to grid with CellType values
-  grid = transformToGrid(maze, start, end);
+  placeDoors();
+  occupants.fill(CellType::EMPTY);
+  rebuildBits();
+  // The exit must be reachable; fall back to a straight route if not
+  if (isValidPoint(start) && isValidPoint(end) &&
+      !sameComponent(start, end)) {
+    carvePath();
+    rebuildBits();
+  }
+  dirtyTiles.fill(true);
+  rooms = generator.getRoomGraph().rooms;
+  roomPathfinder.build(walkable, rooms);
+  // Restored levels draw from the seed afresh; so do generated ones
+  rng.seed(seed);
 }
 
-void Map::clear() {
-  // Initialize grid if it's empty
-  if (grid.empty() || grid[0].empty()) {
-    grid = std::vector<std::vector<CellType>>(height, std::vector<CellType>(width, CellType::EMPTY));
-  } else {
-    for (auto &row : grid) {
-      std::fill(row.begin(), row.end(), CellType::EMPTY);
+TerrainSnapshot Map::snapshotTerrain() const {
+  constexpr unsigned int tileSize = CellLayer::Chunks::chunkSize;
+  TerrainSnapshot snapshot;
+  snapshot.width = width;
+  snapshot.height = height;
+  snapshot.background = terrain.getFillValue();
+  // A dense layer comes as one piece and is cut into tiles here
+  terrain.forEachOwnedChunk([&](int originX, int originY,
+                                GridView<const CellType> part) {
+    for (unsigned int top = 0; top < part.getHeight(); top += tileSize) {
+      for (unsigned int left = 0; left < part.getWidth(); left += tileSize) {
+        const GridView<const CellType> cells(
+            part.row(top) + left,
+            std::min(tileSize, part.getWidth() - left),
+            std::min(tileSize, part.getHeight() - top), part.getStride());
+        bool carved = false;
+        for (unsigned int y = 0; y < cells.getHeight() && !carved; ++y) {
+          carved = std::any_of(cells.row(y), cells.row(y) + cells.getWidth(),
+                               [&snapshot](CellType cell) {
+                                 return cell != snapshot.background;
+                               });
+        }
+        if (!carved) {
+          continue;
+        }
+        TerrainTile tile{originX + static_cast<int>(left),
+                         originY + static_cast<int>(top), cells.getWidth(),
+                         cells.getHeight(), {}};
+        tile.cells.reserve(static_cast<std::size_t>(tile.width) * tile.height);
+        for (unsigned int y = 0; y < cells.getHeight(); ++y) {
+          tile.cells.insert(tile.cells.end(), cells.row(y),
+                            cells.row(y) + cells.getWidth());
+        }
+        snapshot.tiles.push_back(std::move(tile));
+      }
+    }
+  });
+  snapshot.start = start;
+  snapshot.end = end;
+  snapshot.rooms = rooms;
+  snapshot.seed = levelSeed;
+  return snapshot;
+}
+
+bool Map::restoreTerrain(const TerrainSnapshot &snapshot) {
+  if (snapshot.width != width || snapshot.height != height) {
+    return false;
+  }
+  start = snapshot.start;
+  end = snapshot.end;
+  terrain.fill(snapshot.background);
+  for (const TerrainTile &tile : snapshot.tiles) {
+    const CellType *cell = tile.cells.data();
+    for (unsigned int y = 0; y < tile.height; ++y) {
+      for (unsigned int x = 0; x < tile.width; ++x) {
+        terrain.set(tile.x + x, tile.y + y, *cell++);
+      }
     }
   }
+  occupants.fill(CellType::EMPTY);
+  rebuildBits();
+  dirtyTiles.fill(true);
+  rooms = snapshot.rooms;
+  roomPathfinder.build(walkable, rooms);
+  levelSeed = snapshot.seed;
+  rng.seed(levelSeed);
+  return true;
 }
 
-bool Map::isPositionFree(const Point &point) const {
-  if (!isValidPoint(point)) {
+bool Map::loadCells(GridView<const CellType> terrainCells,
+                    GridView<const CellType> occupantCells,
+                    const Point &startPoint, const Point &endPoint) {
+  if (terrainCells.getWidth() != width || terrainCells.getHeight() != height ||
+      occupantCells.getWidth() != width ||
+      occupantCells.getHeight() != height) {
     return false;
   }
-  
-  CellType type = getCellType(point);
-  // Allow movement through floor, doors, empty spaces, grass, trees, and desert
-  return type == CellType::EMPTY || type == CellType::FLOOR ||
-         type == CellType::DOOR || type == CellType::GRASS || 
-         type == CellType::TREE || type == CellType::DESERT;
+  start = startPoint;
+  end = endPoint;
+  levelSeed = 0;
+  terrain.assign(terrainCells, CellType::WALL);
+  occupants.assign(occupantCells, CellType::EMPTY);
+  rebuildBits();
+  dirtyTiles.fill(true);
+  rooms.clear();
+  roomPathfinder.build(walkable, rooms);
+  return true;
+}
+
+void Map::clear() {
+  terrain.fill(CellType::EMPTY);
+  occupants.fill(CellType::EMPTY);
+  walkable.fill(hasTrait(CellType::EMPTY, CellTrait::Walkable));
+  opaque.fill(hasTrait(CellType::EMPTY, CellTrait::Opaque));
+  pushable.fill(false);
+  occupied.fill(false);
+  componentsStale = true;
+  rebuildFreeCells();
+  dirtyTiles.fill(true);
+}
+
+bool Map::isPositionFree(const Point &point) const {
+  // Walkable, unoccupied, and not the exit (nothing spawns or gets pushed
+  // onto it). Out-of-range points read as unset bits.
+  return walkable.test(point.x, point.y) &&
+         !occupied.test(point.x, point.y) &&
+         !hasTrait(terrain(point.x, point.y), CellTrait::Exit);
 }
 
 Point Map::randomFreePosition() const {
-  std::uniform_int_distribution<int> dist_x(0, width - 1);
-  std::uniform_int_distribution<int> dist_y(0, height - 1);
+  if (freeCells.empty()) {
+    return Point(-1, -1);
+  }
+  return freeCells.sample(rng);
+}
+
+std::size_t Map::freeCellCount() const { return freeCells.size(); }
 
-  Point p;
-  do {
-    p = {dist_x(rng), dist_y(rng)};
-  } while (!isPositionFree(p));
+const std::vector<MazeRoom> &Map::getRooms() const { return rooms; }
 
-  return p;
+const HierarchicalPathfinder &Map::getRoomPathfinder() const {
+  return roomPathfinder;
 }
 
 Point Map::getStart() const { return start; }
@@ -87,8 +229,22 @@ double Map::distance(const Point &point1, const Point &point2) const {
 }
 
 void Map::setCellType(const Point &point, CellType symbol) {
-  if (isValidPoint(point)) {
-    grid[point.y][point.x] = symbol;
+  if (hasTrait(symbol, CellTrait::Occupant)) {
+    setOccupant(point, symbol);
+  } else if (isValidPoint(point)) {
+    const CellType before = terrain(point.x, point.y);
+    const bool wasWalkable = walkable.test(point.x, point.y);
+    terrain.set(point.x, point.y, symbol);
+    setTerrainBits(point.x, point.y, symbol);
+    if (!componentsStale) {
+      if (!wasWalkable && walkable.test(point.x, point.y)) {
+        components.add(walkable, point);
+      } else if (wasWalkable && !walkable.test(point.x, point.y)) {
+        componentsStale = true; // May split a component
+      }
+    }
+    updateFreeCell(point.x, point.y);
+    recordChange(point.x, point.y, MapLayer::Terrain, before, symbol);
   } else {
     //  throw std::out_of_range("Point is outside of the map's boundaries.");
   }
@@ -96,119 +252,230 @@ void Map::setCellType(const Point &point, CellType symbol) {
 
 CellType Map::getCellType(const Point &point) const {
   if (isValidPoint(point)) {
-    return grid[point.y][point.x];
+    CellType occupant = occupants(point.x, point.y);
+    return occupant != CellType::EMPTY ? occupant : terrain(point.x, point.y);
   }
   // Return WALL for out-of-bounds points to prevent movement outside map
   return CellType::WALL;
 }
 
+CellType Map::getTerrain(const Point &point) const {
+  if (isValidPoint(point)) {
+    return terrain(point.x, point.y);
+  }
+  return CellType::WALL;
+}
+
+CellType Map::getOccupant(const Point &point) const {
+  if (isValidPoint(point)) {
+    return occupants(point.x, point.y);
+  }
+  return CellType::EMPTY;
+}
+
+void Map::setOccupant(const Point &point, CellType occupant) {
+  if (isValidPoint(point)) {
+    const CellType before = occupants(point.x, point.y);
+    occupants.set(point.x, point.y, occupant);
+    setOccupantBits(point.x, point.y, occupant);
+    updateFreeCell(point.x, point.y);
+    recordChange(point.x, point.y, MapLayer::Occupancy, before, occupant);
+  }
+}
+
+void Map::clearOccupant(const Point &point) {
+  setOccupant(point, CellType::EMPTY);
+}
+
+void Map::moveOccupant(const Point &from, const Point &to) {
+  if (!isValidPoint(from) || !isValidPoint(to) || from == to) {
+    return;
+  }
+  const CellType occupant = occupants(from.x, from.y);
+  const CellType displaced = occupants(to.x, to.y);
+  occupants.set(to.x, to.y, occupant);
+  occupants.set(from.x, from.y, CellType::EMPTY);
+  setOccupantBits(to.x, to.y, occupant);
+  setOccupantBits(from.x, from.y, CellType::EMPTY);
+  updateFreeCell(to.x, to.y);
+  updateFreeCell(from.x, from.y);
+  recordChange(from.x, from.y, MapLayer::Occupancy, occupant, CellType::EMPTY);
+  recordChange(to.x, to.y, MapLayer::Occupancy, displaced, occupant);
+}
+
+const BitGrid &Map::getDirtyTiles() const { return dirtyTiles; }
+
+void Map::clearDirtyTiles() { dirtyTiles.fill(false); }
+
+int Map::subscribe(ChangeListener listener) {
+  listeners.emplace_back(nextSubscription, std::move(listener));
+  return nextSubscription++;
+}
+
+void Map::unsubscribe(int subscription) {
+  listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+                                 [subscription](const auto &entry) {
+                                   return entry.first == subscription;
+                                 }),
+                  listeners.end());
+}
+
+void Map::recordChange(int x, int y, MapLayer layer, CellType before,
+                       CellType after) {
+  if (before == after) {
+    return;
+  }
+  dirtyTiles.set(x >> dirtyTileBits, y >> dirtyTileBits, true);
+  if (listeners.empty()) {
+    return;
+  }
+  const CellChange change{Point(x, y), layer, before, after};
+  for (const auto &entry : listeners) {
+    entry.second(change);
+  }
+}
+
 bool Map::isValidPoint(const Point &point) const {
   return point.x >= 0 && point.x < width && point.y >= 0 && point.y < height;
 }
 
-std::vector<std::vector<CellType>>
-Map::transformToGrid(const std::vector<std::string> &maze, const Point &startPoint,
-                     const Point &endPoint) const {
-  std::vector<std::vector<CellType>> grid;
-  grid.reserve(maze.size());
-
-  // Convert maze characters to CellType - preserve BSP room structure exactly
-  for (size_t rowIndex = 0; rowIndex < maze.size(); ++rowIndex) {
-    const auto &row = maze[rowIndex];
-    std::vector<CellType> gridRow;
-    gridRow.reserve(row.size());
-    for (size_t colIndex = 0; colIndex < row.size(); ++colIndex) {
-      const auto &cell = row[colIndex];
-      if (cell == '#') {
-        gridRow.push_back(CellType::WALL);
-      } else {
-        gridRow.push_back(CellType::FLOOR);
-      }
-    }
-    grid.push_back(gridRow);
+const CellLayer &Map::terrainLayer() const { return terrain; }
+
+const CellLayer &Map::occupancyLayer() const { return occupants; }
+
+const BitGrid &Map::walkableCells() const { return walkable; }
+
+bool Map::sameComponent(const Point &a, const Point &b) const {
+  if (!walkable.test(a.x, a.y) || !walkable.test(b.x, b.y)) {
+    return false;
+  }
+  if (componentsStale) {
+    components.build(walkable);
+    componentsStale = false;
   }
+  return components.connected(a, b);
+}
 
-  // Add doors at corridor entrances (narrow passages between walls)
-  std::uniform_int_distribution<int> doorChance(0, 99);
-  for (size_t y = 1; y < grid.size() - 1; ++y) {
-    for (size_t x = 1; x < grid[y].size() - 1; ++x) {
-      if (grid[y][x] != CellType::FLOOR) continue;
-      
-      // Check if this is a doorway (narrow passage between walls)
-      bool isVerticalDoor = 
-          grid[y][x-1] == CellType::WALL && grid[y][x+1] == CellType::WALL &&
-          (grid[y-1][x] == CellType::FLOOR || grid[y+1][x] == CellType::FLOOR);
-      bool isHorizontalDoor = 
-          grid[y-1][x] == CellType::WALL && grid[y+1][x] == CellType::WALL &&
-          (grid[y][x-1] == CellType::FLOOR || grid[y][x+1] == CellType::FLOOR);
-      
-      if (isVerticalDoor || isHorizontalDoor) {
-        // Place door with 40% chance at corridor entrances
-        if (doorChance(rng) < 40) {
-          grid[y][x] = CellType::DOOR;
-        }
+const BitGrid &Map::opaqueCells() const { return opaque; }
+
+const BitGrid &Map::pushableCells() const { return pushable; }
+
+const BitGrid &Map::occupiedCells() const { return occupied; }
+
+void Map::setTerrainBits(int x, int y, CellType cellType) {
+  walkable.set(x, y, hasTrait(cellType, CellTrait::Walkable));
+  opaque.set(x, y, hasTrait(cellType, CellTrait::Opaque));
+}
+
+void Map::setOccupantBits(int x, int y, CellType occupant) {
+  occupied.set(x, y, occupant != CellType::EMPTY);
+  pushable.set(x, y, hasTrait(occupant, CellTrait::Movable));
+}
+
+void Map::updateFreeCell(int x, int y) {
+  freeCells.assign(x, y, isPositionFree(Point(x, y)));
+}
+
+void Map::rebuildBits() {
+  walkable.fill(false);
+  opaque.fill(false);
+  pushable.fill(false);
+  occupied.fill(false);
+  componentsStale = true;
+  terrain.forEachChunk(0, 0, width, height,
+                       [this](int originX, int originY,
+                              GridView<const CellType> chunk) {
+    for (int y = 0; y < static_cast<int>(chunk.getHeight()); ++y) {
+      const CellType *row = chunk.row(y);
+      for (int x = 0; x < static_cast<int>(chunk.getWidth()); ++x) {
+        setTerrainBits(originX + x, originY + y, row[x]);
+      }
+    }
+  });
+  occupants.forEachOwnedChunk([this](int originX, int originY,
+                                     GridView<const CellType> chunk) {
+    for (int y = 0; y < static_cast<int>(chunk.getHeight()); ++y) {
+      const CellType *row = chunk.row(y);
+      for (int x = 0; x < static_cast<int>(chunk.getWidth()); ++x) {
+        setOccupantBits(originX + x, originY + y, row[x]);
       }
     }
+  });
+  rebuildFreeCells();
+}
+
+void Map::rebuildFreeCells() {
+  freeCells.reset(width, height);
+  for (int y = 0; y < static_cast<int>(height); ++y) {
+    const BitGrid::Word *walkableRow = walkable.row(y);
+    const BitGrid::Word *occupiedRow = occupied.row(y);
+    for (unsigned int word = 0; word < walkable.getWordsPerRow(); ++word) {
+      BitGrid::forEachSetBit(word * BitGrid::wordBits,
+                             walkableRow[word] & ~occupiedRow[word],
+                             [this, y](int x) {
+                               if (!hasTrait(terrain(x, y), CellTrait::Exit)) {
+                                 freeCells.insert(x, y);
+                               }
+                             });
+    }
   }
+}
 
-  // Validate path exists from start to end
-  auto isWalkable = [&grid](const Point &p) {
-    CellType type = grid[p.y][p.x];
-    return type == CellType::FLOOR || type == CellType::DOOR;
-  };
+void Map::placeDoors() {
+  const int cols = static_cast<int>(terrain.getWidth());
 
-  // Simple path validation using BFS
-  if (isValidPoint(startPoint) && isValidPoint(endPoint)) {
-    std::queue<Point> frontier;
-    std::vector<std::vector<bool>> visited(
-        grid.size(), std::vector<bool>(grid[0].size(), false));
-    const std::array<Point, 4> directions = {
-        Point{1, 0}, Point{-1, 0}, Point{0, 1}, Point{0, -1}};
+  // Add doors at corridor entrances (narrow passages between walls). Rows
+  // are scanned in order, so the door rolls and the doors later cells see
+  // as neighbours do not depend on the storage; solid wall chunks cannot
+  // contain floor, so only carved ones are read.
+  std::uniform_int_distribution<int> doorChance(0, 99);
+  const int lastRow = static_cast<int>(terrain.getHeight()) - 1;
+  for (int y = 1; y < lastRow; ++y) {
+    terrain.forEachOwnedSpanInRow(y, [&](int originX,
+                                         GridView<const CellType> span) {
+      for (int cx = 0; cx < static_cast<int>(span.getWidth()); ++cx) {
+        const int x = originX + cx;
+        if (x < 1 || x >= cols - 1) continue;
+        if (span(cx, 0) != CellType::FLOOR) continue;
 
-    if (isWalkable(startPoint)) {
-      frontier.push(startPoint);
-      visited[startPoint.y][startPoint.x] = true;
-    }
+        // Check if this is a doorway (narrow passage between walls)
+        bool isVerticalDoor =
+            terrain(x - 1, y) == CellType::WALL &&
+            terrain(x + 1, y) == CellType::WALL &&
+            (terrain(x, y - 1) == CellType::FLOOR ||
+             terrain(x, y + 1) == CellType::FLOOR);
+        bool isHorizontalDoor =
+            terrain(x, y - 1) == CellType::WALL &&
+            terrain(x, y + 1) == CellType::WALL &&
+            (terrain(x - 1, y) == CellType::FLOOR ||
+             terrain(x + 1, y) == CellType::FLOOR);
 
-    bool found = false;
-    while (!frontier.empty() && !found) {
-      Point current = frontier.front();
-      frontier.pop();
-      if (current.x == endPoint.x && current.y == endPoint.y) {
-        found = true;
-        break;
-      }
-      for (const auto &dir : directions) {
-        Point next{current.x + dir.x, current.y + dir.y};
-        if (!isValidPoint(next) || visited[next.y][next.x]) {
-          continue;
-        }
-        if (!isWalkable(next)) {
-          continue;
+        if (isVerticalDoor || isHorizontalDoor) {
+          // Place door with 40% chance at corridor entrances
+          if (doorChance(rng) < 40) {
+            terrain.set(x, y, CellType::DOOR);
+          }
         }
-        visited[next.y][next.x] = true;
-        frontier.push(next);
-      }
-    }
-    
-    // If no path found, carve a direct path (fallback)
-    if (!found) {
-      int x = startPoint.x;
-      int y = startPoint.y;
-      while (x != endPoint.x) {
-        grid[y][x] = CellType::FLOOR;
-        x += (endPoint.x > x) ? 1 : -1;
       }
-      while (y != endPoint.y) {
-        grid[y][x] = CellType::FLOOR;
-        y += (endPoint.y > y) ? 1 : -1;
-      }
-    }
+    });
   }
+}
 
-  return grid;
+void Map::carvePath() {
+  int x = start.x;
+  int y = start.y;
+  while (x != end.x) {
+    terrain.set(x, y, CellType::FLOOR);
+    x += (end.x > x) ? 1 : -1;
+  }
+  while (y != end.y) {
+    terrain.set(x, y, CellType::FLOOR);
+    y += (end.y > y) ? 1 : -1;
+  }
 }
 
 unsigned int Map::getWidth() const { return width; }
 
 unsigned int Map::getHeight() const { return height; }
+
+std::size_t Map::getStride() const { return terrain.getStride(); }
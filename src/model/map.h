@@ -1,40 +1,184 @@
 #ifndef MAP_H
 #define MAP_H
 
+#include "algorithms/connected_components.h"
+#include "algorithms/hierarchical_pathfinder.h"
 #include "algorithms/maze_generator.h"
+#include "cell_layer.h"
+#include "utils/bit_grid.h"
 #include "utils/game_settings.h"
+#include "utils/grid_view.h"
+#include "utils/indexed_cell_set.h"
 #include "utils/point.h"
+#include <cstdint>
+#include <functional>
 #include <random>
+#include <utility>
 #include <vector>
+
+enum class MapLayer { Terrain, Occupancy };
+
+// Chunk-sized piece of a snapshot's terrain, clipped to the level.
+struct TerrainTile {
+  int x, y; // Top-left cell
+  unsigned int width, height;
+  std::vector<CellType> cells; // Row-major, width * height
+
+  bool operator==(const TerrainTile &other) const {
+    return x == other.x && y == other.y && width == other.width &&
+           height == other.height && cells == other.cells;
+  }
+};
+
+// A generated level's terrain, enough to set the level up again without
+// generating it. Only tiles holding something besides the background are
+// kept, so a snapshot costs about what a chunked layer does.
+struct TerrainSnapshot {
+  unsigned int width = 0;
+  unsigned int height = 0;
+  CellType background = CellType::WALL;
+  std::vector<TerrainTile> tiles;
+  Point start;
+  Point end;
+  std::vector<MazeRoom> rooms;
+  std::uint32_t seed = 0;
+};
+
+// One cell write that changed a layer's value.
+struct CellChange {
+  Point point;
+  MapLayer layer;
+  CellType before;
+  CellType after;
+};
+
 class Map {
 public:
-  std::vector<std::vector<CellType>> grid;
+  using ChangeListener = std::function<void(const CellChange &)>;
+  // Dirty tiles are dirtyTileSize x dirtyTileSize cells.
+  static constexpr int dirtyTileBits = 3;
+  static constexpr int dirtyTileSize = 1 << dirtyTileBits;
 
-  Map(unsigned int width, unsigned int height);
+  Map(unsigned int width, unsigned int height,
+      MapStorage storage = MapStorage::Auto);
+  // Generates a level. The same seed, size and algorithm always give the
+  // same level, and the map's own random draws (e.g. randomFreePosition)
+  // start over from the seed once it is loaded.
+  void loadLevel(std::uint32_t seed,
+                 MazeGeneratorAlgorithm algorithm = MazeGeneratorAlgorithm::BSP);
+  // Generates a level from a random seed.
   void loadLevel();
+  // Copies the terrain, ends and rooms out, e.g. to cache a level.
+  TerrainSnapshot snapshotTerrain() const;
+  // Sets up the level a snapshot was taken of, with no occupants, as if it
+  // had just been generated from the snapshot's seed. Returns false if the
+  // snapshot does not match the map size.
+  bool restoreTerrain(const TerrainSnapshot &snapshot);
+  // Replaces both layers with prebuilt cells (e.g. a mapped level file).
+  // Returns false if the grids do not match the map size.
+  bool loadCells(GridView<const CellType> terrainCells,
+                 GridView<const CellType> occupantCells, const Point &start,
+                 const Point &end);
   void clear();
+  // Occupant if one stands on the cell, terrain otherwise.
   CellType getCellType(const Point &point) const;
+  // Routes the write to the terrain or occupancy layer based on cellType.
   void setCellType(const Point &point, CellType cellType);
+  CellType getTerrain(const Point &point) const;
+  CellType getOccupant(const Point &point) const;
+  void setOccupant(const Point &point, CellType occupant);
+  void clearOccupant(const Point &point);
+  void moveOccupant(const Point &from, const Point &to);
   bool isPositionFree(const Point &point) const;
+  // Uniformly random free cell in O(1); {-1, -1} when none is left.
   Point randomFreePosition() const;
+  std::size_t freeCellCount() const;
   Point getStart() const;
   Point getEnd() const;
   unsigned int getWidth() const;
   unsigned int getHeight() const;
+  std::size_t getStride() const;
   std::vector<Point> getNeighbours(const Point &point) const;
   double distance(const Point &point1, const Point &point2) const;
   bool isValidPoint(const Point &point) const;
 
+  // Read-only access to the two layers for bulk scans, pathfinding and
+  // rendering. Writes go through the setters so the map stays the single
+  // owner of its cells.
+  const CellLayer &terrainLayer() const;
+  const CellLayer &occupancyLayer() const;
+
+  // Per-cell flag bitboards, kept in sync by every setter so scans can test
+  // 64 cells per word instead of decoding each CellType.
+  const BitGrid &walkableCells() const;
+  const BitGrid &opaqueCells() const;
+  const BitGrid &pushableCells() const;
+  const BitGrid &occupiedCells() const;
+
+  // Tiles touched since the last clearDirtyTiles(), one bit per tile.
+  // Bulk rewrites (loadLevel, clear) mark every tile.
+  const BitGrid &getDirtyTiles() const;
+  void clearDirtyTiles();
+
+  // Rooms of the generated level; empty for levels without rooms (e.g.
+  // loaded from a level file).
+  const std::vector<MazeRoom> &getRooms() const;
+  // Room-graph planner over the terrain as of the last loadLevel or
+  // loadCells; later terrain writes are not seen by it.
+  const HierarchicalPathfinder &getRoomPathfinder() const;
+
+  // Both cells are walkable terrain and joined by walkable terrain
+  // (4-connected; occupants ignored). O(1) after the first call following
+  // a bulk load or a write that blocks a cell, which relabel the map.
+  bool sameComponent(const Point &a, const Point &b) const;
+
+  // Listeners hear about every single-cell write that changes a layer,
+  // in order. Bulk rewrites do not emit events; they only dirty tiles.
+  int subscribe(ChangeListener listener);
+  void unsubscribe(int subscription);
+
 private:
   mutable std::mt19937 rng;
+  // Seed of the generated level, 0 for levels from elsewhere.
+  std::uint32_t levelSeed = 0;
   unsigned int width;
   unsigned int height;
   Point start;
   Point end;
+  // Static level geometry (walls, floors, doors, grass, exit...).
+  CellLayer terrain;
+  // What stands on each cell: the occupant's CellType tag, EMPTY if none.
+  CellLayer occupants;
+  BitGrid walkable;
+  BitGrid opaque;
+  BitGrid pushable;
+  BitGrid occupied;
+  // Every cell for which isPositionFree holds.
+  IndexedCellSet freeCells;
+  BitGrid dirtyTiles;
+  std::vector<MazeRoom> rooms;
+  HierarchicalPathfinder roomPathfinder;
+  // Components of the walkable cells. Opened cells are merged in as they
+  // are written; anything else marks the labels stale until next asked.
+  mutable ConnectedComponents components;
+  mutable bool componentsStale = true;
+  std::vector<std::pair<int, ChangeListener>> listeners;
+  int nextSubscription = 0;
+
+  void setTerrainBits(int x, int y, CellType cellType);
+  void setOccupantBits(int x, int y, CellType occupant);
+  void updateFreeCell(int x, int y);
+  void recordChange(int x, int y, MapLayer layer, CellType before,
+                    CellType after);
+  // Recomputes every bitboard and the free-cell set from the layers after a
+  // bulk rewrite.
+  void rebuildBits();
+  void rebuildFreeCells();
 
-  std::vector<std::vector<CellType>>
-  transformToGrid(const std::vector<std::string> &maze, const Point &start,
-                  const Point &end) const;
+  // Turns some corridor entrances of freshly carved terrain into doors.
+  void placeDoors();
+  // Floors an L-shaped route from start to end.
+  void carvePath();
 };
 
 #endif // MAP_H
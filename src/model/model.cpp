@@ -1,4 +1,7 @@
 #include "model.h"
+#include "algorithms/articulation_points.h"
+#include "level_file.h"
+#include "utils/cell_traits.h"
 #include "utils/global_config.h"
 #include <algorithm>
 #include <array>
@@ -10,6 +13,8 @@
 
 const int monsterUpdateSpeed =
     GlobalConfig::getInstance().getConfig<int>("MonsterUpdateSpeed");
+// How far the board shows the player's surroundings undimmed.
+const int playerVisionRadius = 10;
 
 namespace {
 std::string formatCoords(const Point &pos) {
@@ -19,11 +24,56 @@ std::string formatCoords(const Point &pos) {
 template <typename T> std::string labelWithCoords(const T &entity) {
   return entity.toString() + " " + formatCoords(entity.position);
 }
+
+// Records store their kinds as raw bytes; any value past the last
+// enumerator would be cast into an enum the game switches over.
+bool recordKindsAreKnown(const LevelFile &file) {
+  for (const auto &record : file.treasures()) {
+    if (record.bonusType > static_cast<std::uint8_t>(BonusType::Strength)) {
+      return false;
+    }
+  }
+  for (const auto &record : file.potions()) {
+    if (record.potionType >
+        static_cast<std::uint8_t>(Model::PotionType::MANA)) {
+      return false;
+    }
+  }
+  for (const auto &record : file.traps()) {
+    if (record.trapType > static_cast<std::uint8_t>(TrapType::ARROW)) {
+      return false;
+    }
+  }
+  return true;
+}
 } // namespace
 
 Model::Model()
-    : running(false), lastUpdate(std::chrono::steady_clock::now()),
-      currentLevel(0), monstersKilled(0), totalScore(0) {}
+    : runSeed(GlobalConfig::getInstance().getConfigOr<std::uint32_t>("Seed",
+                                                                      0)),
+      nextLevel(GlobalConfig::getInstance().getConfigOr<int>("LevelCacheSize",
+                                                             8)),
+      running(false), lastUpdate(std::chrono::steady_clock::now()),
+      currentLevel(0), monstersKilled(0), totalScore(0) {
+  if (runSeed == 0) {
+    runSeed = std::random_device{}();
+  }
+}
+
+void Model::setSeed(std::uint32_t seed) { runSeed = seed; }
+
+int Model::rollPercent() {
+  return std::uniform_int_distribution<int>(0, 99)(rng);
+}
+
+LevelKey Model::levelKey(int level) const {
+  LevelKey key;
+  // Spread consecutive levels over unrelated seeds
+  key.seed = runSeed ^ (static_cast<std::uint32_t>(level) * 0x9E3779B9u);
+  key.width = GlobalConfig::getInstance().getConfig<int>("MapWidth");
+  key.height = GlobalConfig::getInstance().getConfig<int>("MapHeight");
+  return key;
+}
 
 int Model::getDifficultyMultiplier() const {
   // Difficulty increases by 10% per level
@@ -44,6 +94,9 @@ void Model::spawnMonsters() {
 
     for (int i = 0; i < monsterCount; i++) {
       auto monster = monsterMaker();
+      monster->setChaseField(chaseField);
+      monster->setSight(playerView);
+      monster->setRng(std::mt19937(rng()));
       // Scale monster health and damage with difficulty
       int diffMult = getDifficultyMultiplier();
       monster->health = (monster->health * diffMult) / 100;
@@ -62,7 +115,7 @@ void Model::spawnMonsters() {
     return std::make_shared<Skeleton>(map, player); 
   });
   addMonstersWithMapAndPlayer("OrcsCount", [this]() { 
-    return std::make_shared<Orc>(map, player); 
+    return std::make_shared<Orc>(map, player, pathService); 
   });
 
   // Adding Dragons separately as they don't need map and player
@@ -94,9 +147,18 @@ void Model::restart() {
     player->heal(player->getMaxHealth() / 4);
   }
 
-  map = std::make_shared<Map>(
-      GlobalConfig::getInstance().getConfig<int>("MapWidth"),
-      GlobalConfig::getInstance().getConfig<int>("MapHeight"));
+  // Usually generated in the background while the last level was played
+  const LevelKey key = levelKey(currentLevel);
+  rng.seed(key.seed);
+  enterLevel(nextLevel.take(key));
+  nextLevel.prefetch(levelKey(currentLevel + 1));
+}
+
+void Model::enterLevel(std::shared_ptr<Map> level) {
+  map = std::move(level);
+  chaseField->clear();
+  playerView->clear();
+  watchOpacity();
   info = std::make_shared<InfoDeque>(
       GlobalConfig::getInstance().getConfig<int>("MessageQueueSize"));
 
@@ -104,55 +166,67 @@ void Model::restart() {
   spawnMonsters();
 
   loadMap();
+  pathService->setLevel(map);
 }
 
 void Model::loadMap() {
-  map->loadLevel();
-  player->underlyingCell = map->getCellType(map->getStart());
-  map->setCellType(map->getStart(), CellType::PLAYER);
+  map->setOccupant(map->getStart(), CellType::PLAYER);
   player->move(map->getStart());
 
-  for (const auto &monster : monsters) {
+  // Each kind stops spawning once the map has no free cell left
+  for (std::size_t i = 0; i < monsters.size(); ++i) {
     auto position = map->randomFreePosition();
-    monster->position = position;
-    monster->underlyingCell = map->getCellType(position);
-    map->setCellType(position, monster->cellType);
+    if (!map->isValidPoint(position)) {
+      monsters.resize(i);
+      break;
+    }
+    monsters[i]->position = position;
+    map->setOccupant(position, monsters[i]->cellType);
   }
+  indexMonsters();
 
   // Scale treasure count with level
   int treasureCount =
       GlobalConfig::getInstance().getConfig<int>("TreasureCount");
   treasureCount = treasureCount + (currentLevel * 2); // More treasures at higher levels
   treasures.clear();
+  const int bonusValue =
+      GlobalConfig::getInstance().getConfig<int>("BonusValue");
+  const int bonusExpiration =
+      GlobalConfig::getInstance().getConfig<int>("BonusExpirationCounter");
+  std::uniform_int_distribution<int> bonusTypeDist(0, 2);
   for (int i = 0; i < treasureCount; ++i) {
-    auto treasurePtr = std::make_shared<Treasure>();
     auto position = map->randomFreePosition();
-    treasurePtr->move(position);
-    treasures.emplace(position, std::move(treasurePtr));
-    map->setCellType(position, CellType::TREASURE);
+    if (!map->isValidPoint(position)) {
+      break;
+    }
+    auto bonusType = static_cast<BonusType>(bonusTypeDist(rng));
+    treasures.emplace(position,
+                      std::make_shared<Treasure>(position, bonusValue,
+                                                 bonusType, bonusExpiration));
+    map->setOccupant(position, CellType::TREASURE);
   }
 
   // Spawn potions (player-only pickups)
   int potionCount =
       GlobalConfig::getInstance().getConfig<int>("PotionCount");
   potions.clear();
-  std::random_device rd;
-  std::mt19937 potionRng(rd());
   std::uniform_int_distribution<int> potionTypeDist(0, 99);
   int manaChance =
       GlobalConfig::getInstance().getConfig<int>("PotionManaChance");
 
   for (int i = 0; i < potionCount; ++i) {
     auto position = map->randomFreePosition();
-    PotionType type = potionTypeDist(potionRng) < manaChance
+    if (!map->isValidPoint(position)) {
+      break;
+    }
+    PotionType type = potionTypeDist(rng) < manaChance
                           ? PotionType::MANA
                           : PotionType::HEALTH;
     potions.emplace(position, type);
-    map->setCellType(position, CellType::POTION);
+    map->setOccupant(position, CellType::POTION);
   }
 
-  map->setCellType(map->getEnd(), CellType::END);
-
   // Spawn movable objects strategically to block pockets
   movableObjects.clear();
   placeBlockingObjects();
@@ -162,7 +236,7 @@ void Model::loadMap() {
                    "Entering Dungeon Level " + std::to_string(currentLevel));
   info->addMessage(MessageType::SYSTEM, &player->position,
                    "Monsters: " + std::to_string(monsters.size()) +
-                       " | Treasures: " + std::to_string(treasureCount));
+                       " | Treasures: " + std::to_string(treasures.size()));
   if (currentLevel > 1) {
     info->addMessage(MessageType::SYSTEM, &player->position,
                      "Difficulty increased. Monsters are stronger.");
@@ -177,6 +251,9 @@ void Model::loadMap() {
   // Add blade traps
   for (int i = 0; i < trapCount; ++i) {
     auto position = map->randomFreePosition();
+    if (!map->isValidPoint(position)) {
+      break;
+    }
     auto trap = std::make_shared<BladeTrap>(position);
     traps.push_back(trap);
   }
@@ -184,6 +261,9 @@ void Model::loadMap() {
   // Add spike traps
   for (int i = 0; i < trapCount; ++i) {
     auto position = map->randomFreePosition();
+    if (!map->isValidPoint(position)) {
+      break;
+    }
     auto trap = std::make_shared<SpikeTrap>(position);
     traps.push_back(trap);
   }
@@ -191,141 +271,248 @@ void Model::loadMap() {
   // Add arrow traps (pointing in different directions)
   for (int i = 0; i < trapCount; ++i) {
     auto position = map->randomFreePosition();
+    if (!map->isValidPoint(position)) {
+      break;
+    }
     Point direction = (i % 2 == 0) ? Direction::DOWN : Direction::RIGHT;
     auto trap = std::make_shared<ArrowTrap>(position, direction);
     traps.push_back(trap);
   }
 }
 
-std::vector<Point> Model::findPath(const Point &start, const Point &end) const {
-  // BFS pathfinding that respects current map state
-  if (!map->isValidPoint(start) || !map->isValidPoint(end)) {
-    return {};
+std::shared_ptr<Monster> Model::createMonster(CellType type) {
+  std::shared_ptr<Monster> monster;
+  switch (type) {
+  case CellType::GOBLIN:
+    monster = std::make_shared<Goblin>(map, player);
+    break;
+  case CellType::ORC:
+    monster = std::make_shared<Orc>(map, player, pathService);
+    break;
+  case CellType::TROLL:
+    monster = std::make_shared<Troll>(map, player);
+    break;
+  case CellType::SKELETON:
+    monster = std::make_shared<Skeleton>(map, player);
+    break;
+  case CellType::DRAGON:
+    return std::make_shared<Dragon>();
+  default:
+    return nullptr;
   }
-  
-  auto isWalkableCell = [this](const Point &p) {
-    if (!map->isValidPoint(p)) return false;
-    CellType cell = map->getCellType(p);
-    return cell == CellType::FLOOR || cell == CellType::DOOR ||
-           cell == CellType::GRASS || cell == CellType::TREE ||
-           cell == CellType::DESERT || cell == CellType::END ||
-           cell == CellType::PLAYER || cell == CellType::START ||
-           cell == CellType::GOBLIN || cell == CellType::ORC ||
-           cell == CellType::TROLL || cell == CellType::DRAGON ||
-           cell == CellType::SKELETON || cell == CellType::TREASURE ||
-           cell == CellType::POTION;
-  };
-  
-  if (!isWalkableCell(start)) {
-    return {};
+  monster->setChaseField(chaseField);
+  monster->setSight(playerView);
+  monster->setRng(std::mt19937(rng()));
+  return monster;
+}
+
+int Model::chaseRange() const {
+  GlobalConfig &config = GlobalConfig::getInstance();
+  return std::max({config.getConfig<int>("GoblinFollowRange"),
+                   config.getConfig<int>("OrcFollowRange"),
+                   config.getConfig<int>("TrollFollowRange"),
+                   config.getConfig<int>("SkeletonFollowRange")});
+}
+
+void Model::refreshChaseField() {
+  // Only a player move or a new level changes the field
+  if (chaseField->getSource() == player->position) {
+    return;
   }
-  
-  std::queue<Point> frontier;
-  std::vector<std::vector<bool>> visited(
-      map->getHeight(), std::vector<bool>(map->getWidth(), false));
-  std::vector<std::vector<Point>> prev(
-      map->getHeight(), std::vector<Point>(map->getWidth(), {-1, -1}));
-  
-  frontier.push(start);
-  visited[start.y][start.x] = true;
-  
-  const std::array<Point, 4> directions = {
-      Point{1, 0}, Point{-1, 0}, Point{0, 1}, Point{0, -1}};
-  
-  while (!frontier.empty()) {
-    Point current = frontier.front();
-    frontier.pop();
-    
-    if (current == end) {
-      // Reconstruct path
-      std::vector<Point> path;
-      Point step = end;
-      while (step != start) {
-        path.push_back(step);
-        step = prev[step.y][step.x];
-        if (!map->isValidPoint(step)) break;
-      }
-      path.push_back(start);
-      std::reverse(path.begin(), path.end());
-      return path;
+  const BitGrid &walkable = map->walkableCells();
+  const Point exit = map->getEnd();
+  chaseField->compute(map->getWidth(), map->getHeight(), player->position,
+                      chaseRange(), [&walkable, &exit](int x, int y) {
+                        return walkable.test(x, y) &&
+                               !(x == exit.x && y == exit.y);
+                      });
+}
+
+void Model::refreshPlayerView() {
+  // Far enough for the board and for every monster's follow range
+  playerView->update(map->opaqueCells(), player->position,
+                     std::max(playerVisionRadius, chaseRange()));
+}
+
+void Model::watchOpacity() {
+  map->subscribe([this](const CellChange &change) {
+    if (change.layer == MapLayer::Terrain &&
+        hasTrait(change.before, CellTrait::Opaque) !=
+            hasTrait(change.after, CellTrait::Opaque) &&
+        playerView->covers(change.point)) {
+      playerView->invalidate();
     }
-    
-    for (const auto &dir : directions) {
-      Point next{current.x + dir.x, current.y + dir.y};
-      if (!map->isValidPoint(next) || visited[next.y][next.x]) continue;
-      if (!isWalkableCell(next) && next != end) continue;
-      
-      visited[next.y][next.x] = true;
-      prev[next.y][next.x] = current;
-      frontier.push(next);
+  });
+}
+
+bool Model::saveLevelFile(const std::string &path) const {
+  if (!map || !player) {
+    return false;
+  }
+
+  LevelFileHeader header{};
+  header.startX = map->getStart().x;
+  header.startY = map->getStart().y;
+  header.endX = map->getEnd().x;
+  header.endY = map->getEnd().y;
+  header.playerX = player->position.x;
+  header.playerY = player->position.y;
+  header.level = currentLevel;
+
+  LevelRecords records;
+  for (const auto &monster : monsters) {
+    if (monster->isAlive()) {
+      records.monsters.push_back({monster->position.x, monster->position.y,
+                                  monster->health, monster->strength,
+                                  monster->cellType, {}});
     }
   }
-  
-  return {};
+  for (const auto &[pos, treasure] : treasures) {
+    records.treasures.push_back(
+        {pos.x, pos.y, treasure->getValue(), treasure->getExpirationCounter(),
+         static_cast<std::uint8_t>(treasure->getBonusType()), {}});
+  }
+  for (const auto &[pos, type] : potions) {
+    records.potions.push_back(
+        {pos.x, pos.y, static_cast<std::uint8_t>(type), {}});
+  }
+  for (const auto &trap : traps) {
+    Point direction;
+    if (auto arrow = std::dynamic_pointer_cast<ArrowTrap>(trap)) {
+      direction = arrow->getDirection();
+    }
+    records.traps.push_back({trap->position.x, trap->position.y, direction.x,
+                             direction.y,
+                             static_cast<std::uint8_t>(trap->getTrapType()),
+                             {}});
+  }
+  for (const auto &[pos, object] : movableObjects) {
+    // A monster walking over an object overwrites its cell for good
+    if (map->getOccupant(pos) == object->cellType) {
+      records.movables.push_back({pos.x, pos.y, object->cellType, {}});
+    }
+  }
+
+  return LevelFile::write(path, header, map->terrainLayer(),
+                          map->occupancyLayer(), records);
+}
+
+bool Model::loadLevelFile(const std::string &path) {
+  LevelFile file(path);
+  if (!file.isOpen() || !recordKindsAreKnown(file)) {
+    return false;
+  }
+  const LevelFileHeader &header = file.header();
+
+  // The cell layers are copied row by row straight out of the mapping
+  auto loadedMap = std::make_shared<Map>(header.width, header.height);
+  if (!loadedMap->loadCells(file.terrain(), file.occupants(),
+                            Point(header.startX, header.startY),
+                            Point(header.endX, header.endY))) {
+    return false;
+  }
+  map = std::move(loadedMap);
+  chaseField->clear();
+  playerView->clear();
+  watchOpacity();
+  pathService->setLevel(map);
+
+  if (!player || !player->isAlive()) {
+    player = std::make_shared<Player>();
+    monstersKilled = 0;
+    totalScore = 0;
+  }
+  player->move(Point(header.playerX, header.playerY));
+  currentLevel = header.level;
+  if (!info) {
+    info = std::make_shared<InfoDeque>(
+        GlobalConfig::getInstance().getConfig<int>("MessageQueueSize"));
+  }
+
+  monsters.clear();
+  for (const auto &record : file.monsters()) {
+    auto monster = createMonster(record.type);
+    if (!monster) {
+      continue;
+    }
+    monster->health = record.health;
+    monster->strength = record.strength;
+    monster->position = Point(record.x, record.y);
+    monsters.push_back(std::move(monster));
+  }
+  indexMonsters();
+
+  treasures.clear();
+  for (const auto &record : file.treasures()) {
+    Point pos(record.x, record.y);
+    treasures.emplace(pos, std::make_shared<Treasure>(
+                               pos, record.value,
+                               static_cast<BonusType>(record.bonusType),
+                               record.expirationCounter));
+  }
+
+  potions.clear();
+  for (const auto &record : file.potions()) {
+    potions.emplace(Point(record.x, record.y),
+                    static_cast<PotionType>(record.potionType));
+  }
+
+  traps.clear();
+  for (const auto &record : file.traps()) {
+    Point pos(record.x, record.y);
+    switch (static_cast<TrapType>(record.trapType)) {
+    case TrapType::BLADE:
+      traps.push_back(std::make_shared<BladeTrap>(pos));
+      break;
+    case TrapType::SPIKE:
+      traps.push_back(std::make_shared<SpikeTrap>(pos));
+      break;
+    case TrapType::ARROW:
+      traps.push_back(std::make_shared<ArrowTrap>(
+          pos, Point(record.directionX, record.directionY)));
+      break;
+    }
+  }
+
+  movableObjects.clear();
+  for (const auto &record : file.movables()) {
+    Point pos(record.x, record.y);
+    std::shared_ptr<MovableObject> object;
+    if (record.type == CellType::CRATE) {
+      object = std::make_shared<Crate>(pos);
+    } else if (record.type == CellType::BARREL) {
+      object = std::make_shared<Barrel>(pos);
+    } else {
+      object = std::make_shared<Boulder>(pos);
+    }
+    movableObjects.emplace(pos, std::move(object));
+  }
+
+  activeSpellEffects.clear();
+  info->addMessage(MessageType::SYSTEM, &player->position,
+                   "Entering Dungeon Level " + std::to_string(currentLevel));
+  // Replaces whatever was prefetched for the level left behind
+  nextLevel.prefetch(levelKey(currentLevel + 1));
+  return true;
 }
 
 std::vector<Point> Model::findPathIgnoringMovables(const Point &start, const Point &end) const {
-  // BFS pathfinding that treats movable objects as walkable (can be pushed)
+  // BFS pathfinding that treats movable objects as walkable (can be pushed),
+  // so only the terrain layer matters
   if (!map->isValidPoint(start) || !map->isValidPoint(end)) {
     return {};
   }
   
-  auto isWalkableOrPushable = [this](const Point &p) {
-    if (!map->isValidPoint(p)) return false;
-    CellType cell = map->getCellType(p);
-    return cell == CellType::FLOOR || cell == CellType::DOOR ||
-           cell == CellType::GRASS || cell == CellType::TREE ||
-           cell == CellType::DESERT || cell == CellType::END ||
-           cell == CellType::PLAYER || cell == CellType::START ||
-           cell == CellType::CRATE || cell == CellType::BARREL ||
-           cell == CellType::BOULDER ||
-           cell == CellType::GOBLIN || cell == CellType::ORC ||
-           cell == CellType::TROLL || cell == CellType::DRAGON ||
-           cell == CellType::SKELETON || cell == CellType::TREASURE ||
-           cell == CellType::POTION;
+  const BitGrid &walkable = map->walkableCells();
+  auto isWalkableOrPushable = [&walkable, &end](int x, int y) {
+    return walkable.test(x, y) || (x == end.x && y == end.y);
   };
   
-  std::queue<Point> frontier;
-  std::vector<std::vector<bool>> visited(
-      map->getHeight(), std::vector<bool>(map->getWidth(), false));
-  std::vector<std::vector<Point>> prev(
-      map->getHeight(), std::vector<Point>(map->getWidth(), {-1, -1}));
-  
-  frontier.push(start);
-  visited[start.y][start.x] = true;
-  
-  const std::array<Point, 4> directions = {
-      Point{1, 0}, Point{-1, 0}, Point{0, 1}, Point{0, -1}};
-  
-  while (!frontier.empty()) {
-    Point current = frontier.front();
-    frontier.pop();
-    
-    if (current == end) {
-      std::vector<Point> path;
-      Point step = end;
-      while (step != start) {
-        path.push_back(step);
-        step = prev[step.y][step.x];
-        if (!map->isValidPoint(step)) break;
-      }
-      path.push_back(start);
-      std::reverse(path.begin(), path.end());
-      return path;
-    }
-    
-    for (const auto &dir : directions) {
-      Point next{current.x + dir.x, current.y + dir.y};
-      if (!map->isValidPoint(next) || visited[next.y][next.x]) continue;
-      if (!isWalkableOrPushable(next) && next != end) continue;
-      
-      visited[next.y][next.x] = true;
-      prev[next.y][next.x] = current;
-      frontier.push(next);
-    }
+  if (!terrainSearch.run(map->getWidth(), map->getHeight(), start,
+                         isWalkableOrPushable, CellGoal{end})) {
+    return {};
   }
-  
-  return {};
+  return terrainSearch.path();
 }
 
 void Model::placeBlockingObjects() {
@@ -333,85 +520,123 @@ void Model::placeBlockingObjects() {
   Point startPos = map->getStart();
   Point endPos = map->getEnd();
   
-  std::vector<Point> mainPath = findPath(startPos, endPos);
+  // Nothing movable is placed yet, so the terrain-only room planner gives
+  // the same answer as a full BFS at a fraction of the cost
+  HierarchicalWorkspace workspace;
+  std::vector<Point> mainPath =
+      map->getRoomPathfinder().findPath(workspace, startPos, endPos);
   if (mainPath.empty()) {
     return; // No path, don't place blocking objects
   }
   
-  std::random_device rd;
-  std::mt19937 rng(rd());
-  
   const std::array<Point, 4> directions = {
       Point{1, 0}, Point{-1, 0}, Point{0, 1}, Point{0, -1}};
   
-  auto isWalkable = [this](const Point &p) {
-    if (!map->isValidPoint(p)) return false;
-    CellType cell = map->getCellType(p);
-    return cell == CellType::FLOOR || cell == CellType::GRASS ||
-           cell == CellType::DOOR;
+  const BitGrid &walkable = map->walkableCells();
+  const BitGrid &occupied = map->occupiedCells();
+  const BitGrid &opaque = map->opaqueCells();
+
+  auto isWalkable = [&walkable, &occupied](const Point &p) {
+    return walkable.test(p.x, p.y) && !occupied.test(p.x, p.y);
   };
   
-  auto isWall = [this](const Point &p) {
+  auto isWall = [this, &opaque](const Point &p) {
     if (!map->isValidPoint(p)) return true;
-    CellType cell = map->getCellType(p);
-    return cell == CellType::WALL;
+    return opaque.test(p.x, p.y);
+  };
+
+  // 64 cells starting at x in row y that are free to walk into / solid
+  auto openBits = [&walkable, &occupied](int x, int y) {
+    return walkable.bitsFrom(x, y) & ~occupied.bitsFrom(x, y);
   };
+  auto wallBits = [&opaque](int x, int y) { return opaque.bitsFrom(x, y); };
   
   // Find corridor entrance cells - where corridor meets room
   // These are 1-wide passages with walls on 2 sides and open space ahead
   std::vector<Point> corridorEntrances;
   
-  for (int y = 2; y < static_cast<int>(map->getHeight()) - 2; ++y) {
-    for (int x = 2; x < static_cast<int>(map->getWidth()) - 2; ++x) {
-      Point pos{x, y};
-      if (!isWalkable(pos)) continue;
-      
-      // Skip positions too close to start or end
-      int distToStart = std::abs(pos.x - startPos.x) + std::abs(pos.y - startPos.y);
-      int distToEnd = std::abs(pos.x - endPos.x) + std::abs(pos.y - endPos.y);
-      if (distToStart < 3 || distToEnd < 3) continue;
-      
-      // Check for corridor pattern (walls on opposite sides)
-      bool northWall = isWall(Point{x, y - 1});
-      bool southWall = isWall(Point{x, y + 1});
-      bool eastWall = isWall(Point{x + 1, y});
-      bool westWall = isWall(Point{x - 1, y});
-      
-      bool northOpen = isWalkable(Point{x, y - 1});
-      bool southOpen = isWalkable(Point{x, y + 1});
-      bool eastOpen = isWalkable(Point{x + 1, y});
-      bool westOpen = isWalkable(Point{x - 1, y});
-      
+  const int maxX = static_cast<int>(map->getWidth()) - 2;
+  const int maxY = static_cast<int>(map->getHeight()) - 2;
+  for (int y = 2; y < maxY; ++y) {
+    // Test the corridor pattern for a whole word of cells at once
+    for (int base = 0; base < maxX; base += BitGrid::wordBits) {
       // Horizontal corridor: walls north+south, open east+west
-      bool isHorizCorridor = northWall && southWall && eastOpen && westOpen;
-      // Vertical corridor: walls east+west, open north+south  
-      bool isVertCorridor = eastWall && westWall && northOpen && southOpen;
+      BitGrid::Word horizCorridor = wallBits(base, y - 1) &
+                                    wallBits(base, y + 1) &
+                                    openBits(base + 1, y) &
+                                    openBits(base - 1, y);
+      // Vertical corridor: walls east+west, open north+south
+      BitGrid::Word vertCorridor = wallBits(base + 1, y) &
+                                   wallBits(base - 1, y) &
+                                   openBits(base, y - 1) &
+                                   openBits(base, y + 1);
+      BitGrid::Word candidates =
+          openBits(base, y) & (horizCorridor | vertCorridor);
+      if (base < 2) {
+        candidates &= ~BitGrid::Word(0) << (2 - base);
+      }
+      if (maxX - base < BitGrid::wordBits) {
+        candidates &= (BitGrid::Word(1) << (maxX - base)) - 1;
+      }
+
+      BitGrid::forEachSetBit(base, candidates, [&](int x) {
+        Point pos{x, y};
+      
+        // Skip positions too close to start or end
+        int distToStart = std::abs(pos.x - startPos.x) + std::abs(pos.y - startPos.y);
+        int distToEnd = std::abs(pos.x - endPos.x) + std::abs(pos.y - endPos.y);
+        if (distToStart < 3 || distToEnd < 3) return;
       
-      if (isHorizCorridor || isVertCorridor) {
         // Check if this is at a room entrance (one side leads to more open space)
         int openCount = 0;
         for (const auto &dir : directions) {
           Point neighbor{pos.x + dir.x, pos.y + dir.y};
           if (isWalkable(neighbor)) {
             // Count how open the area beyond is
-            int areaOpenness = 0;
-            for (const auto &dir2 : directions) {
-              Point beyond{neighbor.x + dir2.x, neighbor.y + dir2.y};
-              if (isWalkable(beyond)) areaOpenness++;
-            }
+            int areaOpenness = BitGrid::popcount(
+                walkable.neighbours4(neighbor.x, neighbor.y) &
+                ~occupied.neighbours4(neighbor.x, neighbor.y));
             if (areaOpenness >= 3) openCount++; // Opens into a room
           }
         }
-        
+      
         // Good entrance: corridor opens into room on at least one side
         if (openCount >= 1) {
           corridorEntrances.push_back(pos);
         }
-      }
+      });
     }
   }
   
   std::shuffle(corridorEntrances.begin(), corridorEntrances.end(), rng);
+
+  // Every route from start to exit runs through the separating cells, and
+  // all of them reach such a cell from the same side, the one mainPath
+  // comes from. A blocker there is only fair if that first push moves it
+  // somewhere the player can walk around.
+  //
+  // This is stricter than the old rule, which re-ran a search that treated
+  // movables as walkable and so accepted every entrance: chokepoint
+  // entrances whose first push does not clear the way are now skipped and
+  // the next shuffled entrance is tried instead.
+  ArticulationPoints chokepoints;
+  chokepoints.build(walkable, startPos, endPos);
+  std::unordered_map<Point, std::size_t> pathIndex;
+  for (std::size_t i = 0; i < mainPath.size(); ++i) {
+    pathIndex.emplace(mainPath[i], i);
+  }
+  auto keepsExitReachable = [&](const Point &pos) {
+    if (!chokepoints.separates(pos)) {
+      return true;
+    }
+    auto step = pathIndex.find(pos);
+    if (step == pathIndex.end() || step->second == 0) {
+      return false;
+    }
+    const Point pushed = pos + (pos - mainPath[step->second - 1]);
+    return isWalkable(pushed) && pushed != endPos &&
+           !chokepoints.separates(pushed);
+  };
   
   // Place blocking objects at corridor entrances
   int objectsToPlace = std::min(2 + currentLevel / 2, 4);
@@ -431,7 +656,7 @@ void Model::placeBlockingObjects() {
         break;
       }
     }
-    if (!canBePushed) continue;
+    if (!canBePushed || !keepsExitReachable(pos)) continue;
     
     // Place crate or barrel
     std::shared_ptr<MovableObject> obj;
@@ -441,19 +666,9 @@ void Model::placeBlockingObjects() {
       obj = std::make_shared<Barrel>(pos);
     }
     
-    obj->underlyingCell = map->getCellType(pos);
     movableObjects.emplace(pos, obj);
-    map->setCellType(pos, obj->cellType);
-    
-    // Verify path still exists (can push through)
-    std::vector<Point> pathAfter = findPathIgnoringMovables(startPos, endPos);
-    if (!pathAfter.empty()) {
-      placed++;
-    } else {
-      // Remove if it completely blocks
-      movableObjects.erase(pos);
-      map->setCellType(pos, obj->underlyingCell);
-    }
+    map->setOccupant(pos, obj->cellType);
+    placed++;
   }
   
   // Add a couple boulders in rooms for variety
@@ -463,6 +678,9 @@ void Model::placeBlockingObjects() {
     attempts++;
     
     Point pos = map->randomFreePosition();
+    if (!map->isValidPoint(pos)) {
+      break; // Map is full
+    }
     if (movableObjects.find(pos) != movableObjects.end()) {
       --i;
       continue;
@@ -480,9 +698,8 @@ void Model::placeBlockingObjects() {
     }
     
     auto boulder = std::make_shared<Boulder>(pos);
-    boulder->underlyingCell = map->getCellType(pos);
     movableObjects.emplace(pos, boulder);
-    map->setCellType(pos, CellType::BOULDER);
+    map->setOccupant(pos, CellType::BOULDER);
   }
 }
 
@@ -496,31 +713,41 @@ void Model::update() {
     playerMoves.pop();
     attemptPlayerMove(player, offset);
   }
+  refreshPlayerView();
   
   // Update spell effects
   updateSpellEffects();
 
   if (elapsed.count() < monsterUpdateSpeed) {
+    prefetchRestart();
     return;
   }
 
+  // Paths finished since the last tick, then one field for every chaser
+  pathService->deliver();
+  refreshChaseField();
   for (const auto &monster : monsters) {
     attemptMonsterMove(monster, monster->getVelocity());
   }
 
-  monsters.erase(std::remove_if(monsters.begin(), monsters.end(),
-                                [](const std::shared_ptr<Monster> &monster) {
-                                  return !monster->isAlive();
-                                }),
-                 monsters.end());
+  dropDeadMonsters();
 
   lastUpdate = now;
+  prefetchRestart();
+}
+
+void Model::prefetchRestart() {
+  // After a death restart() starts over at level 1; build it while the
+  // game over screen shows instead of waiting on the next level
+  if (!player->isAlive()) {
+    nextLevel.prefetch(levelKey(1));
+  }
 }
 
 void Model::fight(const std::shared_ptr<Monster> &monster) {
 
   auto attack = [&](const auto &attacker, const auto &defender) {
-    double successRate = (rand() % 100) / 100.0; // random value between 0 and 1
+    double successRate = rollPercent() / 100.0; // random value between 0 and 1
     bool attackerIsPlayer =
         (static_cast<const void *>(attacker.get()) ==
          static_cast<const void *>(player.get()));
@@ -560,7 +787,7 @@ void Model::fight(const std::shared_ptr<Monster> &monster) {
     int damage = static_cast<int>(attacker->strength * successRate);
 
     // Critical hit system (10% chance for 2x damage)
-    bool isCritical = (rand() % 100) < 10;
+    bool isCritical = rollPercent() < 10;
     if (isCritical) {
       damage *= 2;
       info->addMessage(MessageType::COMBAT, &attacker->position,
@@ -578,14 +805,13 @@ void Model::fight(const std::shared_ptr<Monster> &monster) {
 
   auto updateMapAfterFight = [&](const auto &defeatedMonster) {
     if (!defeatedMonster->isAlive()) {
-      map->setCellType(defeatedMonster->position,
-                       defeatedMonster->underlyingCell);
+      removeKilledMonster(*defeatedMonster);
     }
 
     if (!player->isAlive()) {
-      map->setCellType(player->position, player->underlyingCell);
+      map->clearOccupant(player->position);
     } else {
-      map->setCellType(player->position, player->cellType);
+      map->setOccupant(player->position, player->cellType);
     }
   };
 
@@ -632,7 +858,7 @@ void Model::exploreTreasure(const std::shared_ptr<Treasure> &treasure) {
 
   // Initialize success rate (you might want to tweak the numbers depending on
   // your game balance)
-  double successRate = (rand() % 100) / 100.0; // random value between 0 and 1
+  double successRate = rollPercent() / 100.0; // random value between 0 and 1
 
   // Define the mechanism of exploring treasure
   auto explore = [&](const auto &explorer, const auto &treasure,
@@ -667,7 +893,7 @@ void Model::exploreTreasure(const std::shared_ptr<Treasure> &treasure) {
   // Define what happens on the map after treasure exploration
   auto updateMapAfterExploration = [&](const auto &explorer,
                                        const auto &exploredTreasure) {
-    map->setCellType(exploredTreasure->position, CellType::FLOOR);
+    map->clearOccupant(exploredTreasure->position);
     treasures.erase(exploredTreasure->position);
   };
 
@@ -760,27 +986,25 @@ void Model::checkSpellCollisions(const std::shared_ptr<SpellEffect> &effect) {
     }
     
     // Check if spell hits a monster
-    for (auto &monster : monsters) {
-      if (monster->position == pos && monster->isAlive()) {
-        int damage = effect->getDamage();
-        monster->takeDamage(damage);
-        
+    if (auto monster = monsterAt(pos)) {
+      int damage = effect->getDamage();
+      monster->takeDamage(damage);
+      
+      info->addMessage(MessageType::COMBAT, &player->position,
+                       spell->getName() + " hits " +
+                           labelWithCoords(*monster) + " for " +
+                           std::to_string(damage) + ".");
+      
+      if (!monster->isAlive()) {
+        monstersKilled++;
+        int expGain = monsterExpMap[monster->cellType];
+        int scoreGain = expGain * currentLevel;
+        totalScore += scoreGain;
+        player->addExperience(expGain);
         info->addMessage(MessageType::COMBAT, &player->position,
-                         spell->getName() + " hits " +
-                             labelWithCoords(*monster) + " for " +
-                             std::to_string(damage) + ".");
-        
-        if (!monster->isAlive()) {
-          monstersKilled++;
-          int expGain = monsterExpMap[monster->cellType];
-          int scoreGain = expGain * currentLevel;
-          totalScore += scoreGain;
-          player->addExperience(expGain);
-          info->addMessage(MessageType::COMBAT, &player->position,
-                           "You defeated " + labelWithCoords(*monster) +
-                               ". +" + std::to_string(expGain) + " EXP");
-          map->setCellType(monster->position, monster->underlyingCell);
-        }
+                         "You defeated " + labelWithCoords(*monster) +
+                             ". +" + std::to_string(expGain) + " EXP");
+        removeKilledMonster(*monster);
       }
     }
   }
@@ -813,19 +1037,15 @@ void Model::attemptPlayerMove(const std::shared_ptr<Player> &player,
     if (!player->isAlive()) {
       info->addMessage(MessageType::SYSTEM, &player->position,
                        "You were killed by " + trap->toString() + ".");
-      map->setCellType(player->position, player->underlyingCell);
+      map->clearOccupant(player->position);
       return;
     }
   }
 
   if (isMonster(newPos)) {
-    for (const auto &monster : monsters) {
-      if (monster->position == newPos) {
-        fight(monster);
-        monsters.erase(std::remove(monsters.begin(), monsters.end(), monster),
-                       monsters.end());
-        break;
-      }
+    // Dead monsters are dropped from `monsters` on the next monster tick
+    if (auto monster = monsterAt(newPos)) {
+      fight(monster);
     }
     return;
   } else if (isMovableObject(newPos)) {
@@ -855,7 +1075,7 @@ void Model::attemptPlayerMove(const std::shared_ptr<Player> &player,
     }
 
     potions.erase(newPos);
-    map->setCellType(newPos, CellType::FLOOR);
+    map->clearOccupant(newPos);
   }
 
   else if (isExit(newPos)) {
@@ -867,12 +1087,15 @@ void Model::attemptPlayerMove(const std::shared_ptr<Player> &player,
 
 void Model::attemptMonsterMove(const std::shared_ptr<Monster> &monster,
                                const Point &direction) {
+  if (!monster->isAlive()) {
+    return; // Killed by a spell this tick, removed after the update loop
+  }
+
   auto currentPos = monster->position;
   auto newPos = currentPos + direction;
 
-  CellType targetCell = map->getCellType(newPos);
   bool isPlayerOnlyItem =
-      targetCell == CellType::TREASURE || targetCell == CellType::POTION;
+      hasTrait(map->getOccupant(newPos), CellTrait::Pickup);
 
   if (isWall(newPos) || isMonster(newPos) || isExit(newPos) ||
       isPlayerOnlyItem) {
@@ -888,11 +1111,65 @@ void Model::attemptMonsterMove(const std::shared_ptr<Monster> &monster,
 
 void Model::updateEntityPosition(const std::shared_ptr<Entity> &entity,
                                  const Point &oldPos, const Point &newPos) {
-  auto cellType = entity->cellType;
-  map->setCellType(oldPos, entity->underlyingCell);
-  entity->underlyingCell = map->getCellType(newPos);
-  map->setCellType(newPos, cellType);
+  map->moveOccupant(oldPos, newPos);
   entity->move(newPos);
+
+  // Monsters carry their slot along; the player never has one
+  auto found = monsterSlots.find(oldPos);
+  if (found != monsterSlots.end() && oldPos != newPos) {
+    const int slot = found->second;
+    monsterSlots.erase(found);
+    monsterSlots[newPos] = slot;
+  }
+}
+
+std::shared_ptr<Monster> Model::monsterAt(const Point &point) const {
+  if (!map) {
+    return nullptr;
+  }
+  auto found = monsterSlots.find(point);
+  return found != monsterSlots.end() ? monsters[found->second] : nullptr;
+}
+
+void Model::indexMonsters() {
+  monsterSlots.clear();
+  monsterSlots.reserve(monsters.size());
+  for (std::size_t slot = 0; slot < monsters.size(); ++slot) {
+    const auto &monster = monsters[slot];
+    if (monster->isAlive() && map->isValidPoint(monster->position)) {
+      monsterSlots[monster->position] = static_cast<int>(slot);
+    }
+  }
+}
+
+void Model::removeKilledMonster(const Monster &monster) {
+  map->clearOccupant(monster.position);
+  monsterSlots.erase(monster.position);
+}
+
+void Model::dropDeadMonsters() {
+  // Only the monster moved into each freed slot needs its entry patched
+  std::size_t slot = 0;
+  while (slot < monsters.size()) {
+    if (monsters[slot]->isAlive()) {
+      ++slot;
+      continue;
+    }
+    auto dead = monsterSlots.find(monsters[slot]->position);
+    if (dead != monsterSlots.end() && dead->second == static_cast<int>(slot)) {
+      monsterSlots.erase(dead);
+    }
+    const int last = static_cast<int>(monsters.size()) - 1;
+    if (static_cast<int>(slot) != last) {
+      monsters[slot] = std::move(monsters.back());
+      // A dead one's cell may hold someone else's entry by now
+      auto found = monsterSlots.find(monsters[slot]->position);
+      if (found != monsterSlots.end() && found->second == last) {
+        found->second = static_cast<int>(slot);
+      }
+    }
+    monsters.pop_back();
+  }
 }
 
 std::unordered_map<std::string, std::string> Model::getPlayerStats() {
@@ -913,7 +1190,10 @@ std::unordered_map<std::string, std::string> Model::getPlayerStats() {
   result["DungeonLevel"] = std::to_string(currentLevel);
   result["MonstersKilled"] = std::to_string(monstersKilled);
   result["Score"] = std::to_string(totalScore);
-  result["MonstersRemaining"] = std::to_string(monsters.size());
+  // Monsters killed this tick stay in `monsters` until the next monster tick
+  result["MonstersRemaining"] = std::to_string(std::count_if(
+      monsters.begin(), monsters.end(),
+      [](const std::shared_ptr<Monster> &monster) { return monster->isAlive(); }));
 
   return result;
 }
@@ -924,40 +1204,31 @@ bool Model::isWall(const Point &point) {
   if (!map->isValidPoint(point)) {
     return true;
   }
-  CellType cell = map->getCellType(point);
-  return cell == CellType::WALL || cell == CellType::MOUNTAIN || cell == CellType::WATER;
+  return map->opaqueCells().test(point.x, point.y);
 }
 
 bool Model::isPlayer(const Point &point) {
-  return map->getCellType(point) == CellType::PLAYER;
+  return map->getOccupant(point) == CellType::PLAYER;
 }
 
 bool Model::isExit(const Point &point) {
-  return map->getCellType(point) == CellType::END;
+  return hasTrait(map->getTerrain(point), CellTrait::Exit);
 }
 
 bool Model::isTreasure(const Point &point) {
-  return map->getCellType(point) == CellType::TREASURE;
+  return map->getOccupant(point) == CellType::TREASURE;
 }
 
 bool Model::isPotion(const Point &point) {
-  return map->getCellType(point) == CellType::POTION;
+  return map->getOccupant(point) == CellType::POTION;
 }
 
 bool Model::isMonster(const Point &point) {
-  CellType cell = map->getCellType(point);
-  return cell == CellType::GOBLIN ||
-         cell == CellType::ORC ||
-         cell == CellType::TROLL ||
-         cell == CellType::DRAGON ||
-         cell == CellType::SKELETON;
+  return hasTrait(map->getOccupant(point), CellTrait::Monster);
 }
 
 bool Model::isMovableObject(const Point &point) {
-  CellType cell = map->getCellType(point);
-  return cell == CellType::BOULDER ||
-         cell == CellType::CRATE ||
-         cell == CellType::BARREL;
+  return map->pushableCells().test(point.x, point.y);
 }
 
 bool Model::tryPushObject(const Point &objectPos, const Point &direction) {
@@ -969,9 +1240,8 @@ bool Model::tryPushObject(const Point &objectPos, const Point &direction) {
   auto object = movableObjects[objectPos];
   Point newPos = objectPos + direction;
   
-  // Check if the new position is free
-  if (!map->isPositionFree(newPos) || isMonster(newPos) || 
-      isPlayer(newPos) || isMovableObject(newPos) || isTreasure(newPos)) {
+  // Check if the new position is free (walkable terrain, nobody on it)
+  if (!map->isPositionFree(newPos)) {
     return false;
   }
   
@@ -1017,7 +1287,7 @@ void Model::checkTrapCollisions() {
           info->addMessage(MessageType::SYSTEM, &player->position,
                            "You were killed by " + labelWithCoords(*trap) +
                                ".");
-          map->setCellType(player->position, player->underlyingCell);
+          map->clearOccupant(player->position);
         }
         trap->deactivateProjectile(i);
         continue;
@@ -1,16 +1,21 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#include "algorithms/field_of_view.h"
+#include "algorithms/grid_search.h"
 #include "entities/monster.h"
 #include "entities/movable_object.h"
 #include "entities/player.h"
 #include "entities/treasure.h"
 #include "entities/trap.h"
+#include "level_prefetcher.h"
 #include "map.h"
+#include "path_service.h"
 #include "spell/spell_effect.h"
 #include "utils/direction.h"
 #include "utils/info_deque.h"
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -25,8 +30,23 @@ public:
   void queuePlayerMove(const Point &point);
   void castPlayerSpell(int spellIndex, const Point &direction);
   void restart();
+  // Plays `level` as the current level with a fresh population, keeping
+  // the player and the run's progress. restart() enters every generated
+  // level through here.
+  void enterLevel(std::shared_ptr<Map> level);
+  // Seeds every level of the next runs: the same seed replays the same
+  // levels, populations and fights. Defaults to config's Seed, or a random
+  // seed when that is 0.
+  void setSeed(std::uint32_t seed);
+  // Writes the current level, with its entities, to a binary level file.
+  bool saveLevelFile(const std::string &path) const;
+  // Replaces the current level with one read from a level file. Returns
+  // false (leaving the level untouched) if the file cannot be used.
+  bool loadLevelFile(const std::string &path);
   bool isGameOver();
   std::unordered_map<std::string, std::string> getPlayerStats();
+  // Living monster standing on the cell, nullptr if none.
+  std::shared_ptr<Monster> monsterAt(const Point &point) const;
 
   std::shared_ptr<Player> player;
   std::shared_ptr<InfoDeque> info;
@@ -38,6 +58,9 @@ public:
   std::unordered_map<Point, std::shared_ptr<MovableObject>> movableObjects;
   std::vector<std::shared_ptr<SpellEffect>> activeSpellEffects;
   std::vector<std::shared_ptr<Trap>> traps;
+  // What the player can see, shared by the renderer and by monsters
+  // checking whether they see the player. Refreshed once per update.
+  std::shared_ptr<FieldOfView> playerView = std::make_shared<FieldOfView>();
 
   // Game progression
   int currentLevel;
@@ -45,10 +68,24 @@ public:
   int totalScore;
 
 private:
+  // Puts the player and a fresh population on the newly generated map.
   void loadMap();
+  // Generation settings of the given level of the current run.
+  LevelKey levelKey(int level) const;
+  // Starts generating level 1 once the player has died.
+  void prefetchRestart();
+  // 0-99 from the level's seeded draws.
+  int rollPercent();
   void fight(const std::shared_ptr<Monster> &monster);
   void exploreTreasure(const std::shared_ptr<Treasure> &treasure);
   void spawnMonsters();
+  std::shared_ptr<Monster> createMonster(CellType type);
+  // Largest follow range of any chaser: how far the chase field reaches.
+  int chaseRange() const;
+  void refreshChaseField();
+  void refreshPlayerView();
+  // Stales the player's view whenever a cell it covers changes opacity.
+  void watchOpacity();
   int getDifficultyMultiplier() const;
   
   void updateSpellEffects();
@@ -58,7 +95,6 @@ private:
   void checkTrapCollisions();
   
   void placeBlockingObjects();
-  std::vector<Point> findPath(const Point &start, const Point &end) const;
   std::vector<Point> findPathIgnoringMovables(const Point &start, const Point &end) const;
 
   void attemptPlayerMove(const std::shared_ptr<Player> &player,
@@ -67,6 +103,10 @@ private:
                           const Point &direction);
   void updateEntityPosition(const std::shared_ptr<Entity> &entity,
                             const Point &oldPos, const Point &newPos);
+  void indexMonsters();
+  void removeKilledMonster(const Monster &monster);
+  // Swap-removes dead monsters, re-slotting only the survivors that moved.
+  void dropDeadMonsters();
   bool isWall(const Point &point);
   bool isPlayer(const Point &point);
   bool isExit(const Point &point);
@@ -75,6 +115,22 @@ private:
   bool isPotion(const Point &point);
   bool isMovableObject(const Point &point);
   bool tryPushObject(const Point &objectPos, const Point &direction);
+  // Slot in `monsters` of the monster on each occupied cell. Sparse, so it
+  // costs O(monsters) whatever the map size. Kept in step with every spawn,
+  // move and death.
+  std::unordered_map<Point, int> monsterSlots;
+  // Walking distances to the player, shared by every chasing monster.
+  std::shared_ptr<DistanceField> chaseField =
+      std::make_shared<DistanceField>();
+  std::uint32_t runSeed;
+  // Every random choice of the current level, reseeded per level.
+  std::mt19937 rng;
+  // Generates the next level while this one is played.
+  LevelPrefetcher nextLevel;
+  // Background planner for Orc chases.
+  std::shared_ptr<PathService> pathService = std::make_shared<PathService>();
+  // Scratch buffers for findPathIgnoringMovables, kept between calls.
+  mutable GridSearch<> terrainSearch;
   std::atomic_bool running;
   std::queue<Point> playerMoves;
   std::chrono::steady_clock::time_point lastUpdate;
@@ -0,0 +1,213 @@
+#include "path_service.h"
+#include <algorithm>
+
+namespace {
+// Lets AStar read a BitGrid as a grid of bools.
+struct NavigableView {
+  const BitGrid &bits;
+
+  unsigned int getWidth() const { return bits.getWidth(); }
+  unsigned int getHeight() const { return bits.getHeight(); }
+  bool operator()(int x, int y) const { return bits.test(x, y); }
+};
+} // namespace
+
+BitGrid navigableTerrain(const Map &map) {
+  BitGrid navigable = map.walkableCells();
+  const Point exit = map.getEnd();
+  if (map.isValidPoint(exit)) {
+    navigable.set(exit.x, exit.y, false);
+  }
+  return navigable;
+}
+
+PathService::PathService(unsigned int workerCount) {
+  workers.reserve(workerCount);
+  for (unsigned int i = 0; i < workerCount; ++i) {
+    workers.emplace_back(&PathService::work, this);
+  }
+}
+
+PathService::~PathService() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  workAvailable.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+unsigned int PathService::defaultWorkerCount() {
+  // Leave the game and render threads a core; a few workers are plenty
+  const unsigned int cores = std::thread::hardware_concurrency();
+  return std::clamp(cores > 2 ? cores - 2 : 1u, 1u, 4u);
+}
+
+void PathService::setLevel(const std::shared_ptr<const Map> &map) {
+  auto next = std::make_shared<Level>();
+  next->map = map;
+  next->navigable = navigableTerrain(*map);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  level = std::move(next);
+  // Queued requests for the old level come back unplanned
+  for (auto &job : queue) {
+    finished.push_back(std::move(job));
+  }
+  queue.clear();
+  pending.clear();
+  idle.notify_all();
+}
+
+std::shared_ptr<PathRequest>
+PathService::request(const Point &start, const Point &goal,
+                     std::shared_ptr<DStarLite> pursuit) {
+  auto pathRequest = std::make_shared<PathRequest>();
+  pathRequest->start = start;
+  pathRequest->goal = goal;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!level) {
+      pathRequest->ready = true; // Nothing to plan on
+      return pathRequest;
+    }
+    const JobKey key{start, goal};
+    if (!pursuit) {
+      auto found = pending.find(key);
+      if (found != pending.end()) {
+        found->second->waiters.push_back(pathRequest);
+        return pathRequest;
+      }
+    }
+    auto job = std::make_shared<Job>();
+    job->key = key;
+    job->level = level;
+    job->waiters.push_back(pathRequest);
+    if (pursuit) {
+      job->pursuit = std::move(pursuit);
+    } else {
+      pending.emplace(key, job);
+    }
+    queue.push_back(std::move(job));
+  }
+  workAvailable.notify_one();
+  return pathRequest;
+}
+
+void PathService::deliver() {
+  std::vector<std::shared_ptr<Job>> done;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (workers.empty()) {
+      while (std::shared_ptr<Job> job = takeJob()) {
+        search(*job, gridWorkspace, roomWorkspace);
+        finish(std::move(job));
+      }
+    }
+    done.swap(finished);
+  }
+  for (const auto &job : done) {
+    for (const auto &waiter : job->waiters) {
+      if (auto pathRequest = waiter.lock()) {
+        pathRequest->path = job->path;
+        pathRequest->ready = true;
+      }
+    }
+  }
+}
+
+void PathService::waitUntilIdle() {
+  std::unique_lock<std::mutex> lock(mutex);
+  idle.wait(lock, [this] {
+    return workers.empty() || (queue.empty() && running == 0);
+  });
+}
+
+std::size_t PathService::completedSearches() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return searches;
+}
+
+std::shared_ptr<PathService::Job> PathService::takeJob() {
+  while (!queue.empty()) {
+    std::shared_ptr<Job> job = std::move(queue.front());
+    queue.pop_front();
+    // Skip searches nobody is waiting for any more
+    const bool wanted =
+        std::any_of(job->waiters.begin(), job->waiters.end(),
+                    [](const auto &waiter) { return !waiter.expired(); });
+    if (wanted) {
+      return job;
+    }
+    auto found = pending.find(job->key);
+    if (found != pending.end() && found->second == job) {
+      pending.erase(found);
+    }
+  }
+  return nullptr;
+}
+
+void PathService::search(Job &job, AStarWorkspace &gridWorkspace,
+                         HierarchicalWorkspace &roomWorkspace) {
+  const Level &jobLevel = *job.level;
+  if (job.pursuit) {
+    if (!job.pursuit->isReady()) {
+      job.pursuit->reset(jobLevel.navigable);
+    }
+    job.path = job.pursuit->plan(job.key.start, job.key.goal);
+    return;
+  }
+  if (!jobLevel.map->getRooms().empty()) {
+    std::vector<Point> route = jobLevel.map->getRoomPathfinder().findPath(
+        roomWorkspace, job.key.start, job.key.goal);
+    job.path.assign(route.begin(), route.end());
+    return;
+  }
+  AStar<bool> aStar(gridWorkspace, NavigableView{jobLevel.navigable},
+                    job.key.start, job.key.goal,
+                    [](bool navigable) { return navigable; },
+                    AStarMode::JumpPoint);
+  job.path = aStar.getPath();
+}
+
+void PathService::finish(std::shared_ptr<Job> job) {
+  ++searches;
+  auto found = pending.find(job->key);
+  if (found != pending.end() && found->second == job) {
+    pending.erase(found);
+  }
+  // Paths planned on a level that has since been replaced are dropped, but
+  // their requests still become ready so nobody waits on them forever
+  if (job->level != level) {
+    job->path.clear();
+  }
+  finished.push_back(std::move(job));
+}
+
+void PathService::work() {
+  AStarWorkspace workerGridWorkspace;
+  HierarchicalWorkspace workerRoomWorkspace;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    workAvailable.wait(lock, [this] { return stopping || !queue.empty(); });
+    if (stopping) {
+      return;
+    }
+    std::shared_ptr<Job> job = takeJob();
+    if (job) {
+      ++running;
+      lock.unlock();
+      search(*job, workerGridWorkspace, workerRoomWorkspace);
+      lock.lock();
+      --running;
+      finish(std::move(job));
+    }
+    if (queue.empty() && running == 0) {
+      idle.notify_all();
+    }
+  }
+}
@@ -0,0 +1,130 @@
+#ifndef PATH_SERVICE_H
+#define PATH_SERVICE_H
+
+#include "algorithms/a_star.h"
+#include "algorithms/d_star_lite.h"
+#include "algorithms/hierarchical_pathfinder.h"
+#include "map.h"
+#include "utils/bit_grid.h"
+#include "utils/point.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Walkable terrain minus the exit: the cells monsters plan on.
+BitGrid navigableTerrain(const Map &map);
+
+// One path asked of a PathService. The service fills it in during
+// deliver(), on the game thread, so the requester reads it without locks.
+// Dropping the last reference cancels the request.
+struct PathRequest {
+  Point start;
+  Point goal;
+  bool ready = false;
+  std::deque<Point> path; // Start and goal included; empty if unreachable
+};
+
+// Fixed pool of pathfinding threads shared by every monster that plans
+// ahead. Each worker keeps its own search workspaces, so steady-state
+// requests do not allocate or spawn threads. Requests for the same
+// (start, goal) that are still waiting share one search, and finished
+// paths reach their requesters only in deliver(), i.e. at tick boundaries.
+//
+// With zero workers the service runs queued searches itself inside
+// deliver(), on the calling thread, which makes it fully deterministic.
+class PathService {
+public:
+  explicit PathService(unsigned int workerCount = defaultWorkerCount());
+  ~PathService();
+  PathService(const PathService &) = delete;
+  PathService &operator=(const PathService &) = delete;
+
+  // Plans on `map` from now on. Searches read a snapshot of its navigable
+  // terrain, or its room planner (fixed once the level is loaded), never
+  // the live layers. Requests for the previous level still waiting or
+  // running become ready with an empty path at the next deliver().
+  void setLevel(const std::shared_ptr<const Map> &map);
+
+  // Without a `pursuit`, the level's room planner answers, or jump point
+  // search on levels without rooms; Orcs ask this way for detours their
+  // windowed pursuit cannot see. With a `pursuit`, the search repairs that
+  // pursuit's previous one rather than starting over, and is never shared
+  // with other requests.
+  // The caller must leave `pursuit` alone until the request is ready or
+  // dropped. A pursuit that was never reset starts from the level snapshot.
+  std::shared_ptr<PathRequest>
+  request(const Point &start, const Point &goal,
+          std::shared_ptr<DStarLite> pursuit = nullptr);
+
+  // Hands finished paths to the requests still alive. Game thread only.
+  void deliver();
+
+  // Blocks until the workers have drained the queue (used by tests).
+  void waitUntilIdle();
+
+  // Searches actually run since construction; shared and cancelled
+  // requests do not count.
+  std::size_t completedSearches() const;
+
+  static unsigned int defaultWorkerCount();
+
+private:
+  // What workers plan on: immutable once published.
+  struct Level {
+    std::shared_ptr<const Map> map;
+    BitGrid navigable; // Walkable terrain minus the exit
+  };
+
+  struct JobKey {
+    Point start;
+    Point goal;
+    bool operator==(const JobKey &other) const {
+      return start == other.start && goal == other.goal;
+    }
+  };
+  struct JobKeyHash {
+    std::size_t operator()(const JobKey &key) const noexcept {
+      return std::hash<Point>()(key.start) * 31 ^
+             std::hash<Point>()(key.goal);
+    }
+  };
+
+  struct Job {
+    JobKey key;
+    std::shared_ptr<const Level> level;
+    std::vector<std::weak_ptr<PathRequest>> waiters;
+    std::shared_ptr<DStarLite> pursuit; // Set for incremental requests
+    std::deque<Point> path;
+  };
+
+  mutable std::mutex mutex;
+  std::condition_variable workAvailable;
+  std::condition_variable idle;
+  std::shared_ptr<const Level> level;
+  std::deque<std::shared_ptr<Job>> queue;
+  // Queued or running jobs of the current level, for sharing
+  std::unordered_map<JobKey, std::shared_ptr<Job>, JobKeyHash> pending;
+  std::vector<std::shared_ptr<Job>> finished;
+  std::size_t running = 0;
+  std::size_t searches = 0;
+  bool stopping = false;
+  std::vector<std::thread> workers;
+  // Used by deliver() when there are no workers
+  AStarWorkspace gridWorkspace;
+  HierarchicalWorkspace roomWorkspace;
+
+  void work();
+  // Next job someone still waits for, or nullptr. Caller holds the mutex.
+  std::shared_ptr<Job> takeJob();
+  static void search(Job &job, AStarWorkspace &gridWorkspace,
+                     HierarchicalWorkspace &roomWorkspace);
+  // Publishes a searched job. Caller holds the mutex.
+  void finish(std::shared_ptr<Job> job);
+};
+
+#endif // PATH_SERVICE_H
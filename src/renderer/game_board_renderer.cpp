@@ -1,6 +1,8 @@
 #include "game_board_renderer.h"
+#include "algorithms/field_of_view.h"
 #include "model/spell/spell_effect.h"
 #include "model/entities/trap.h"
+#include "utils/cell_traits.h"
 #include "utils/global_config.h"
 #include <algorithm>
 #include <array>
@@ -327,9 +329,13 @@ void GameBoardRenderer::drawBoard() {
   drawPanel(boardPanel, " DUNGEON ", static_cast<int>(ColorPair::UI_BORDER),
             static_cast<int>(ColorPair::UI_TITLE));
 
+  if (data.terrain == nullptr || data.occupants == nullptr) {
+    return;
+  }
+
   // Calculate board dimensions based on terminal size and grid size
-  int gridRowSize = static_cast<int>(data.grid.size());
-  int gridColSize = static_cast<int>(data.grid[0].size());
+  int gridRowSize = static_cast<int>(data.terrain->getHeight());
+  int gridColSize = static_cast<int>(data.terrain->getWidth());
   int boardHeight =
       std::min(boardPanel.height() - 2, gridRowSize);
   int boardWidth =
@@ -375,85 +381,96 @@ void GameBoardRenderer::drawBoard() {
     attroff(attrs);
   };
 
-  for (int y = 0; y < boardHeight; ++y) {
-    for (int x = 0; x < boardWidth; ++x) {
-      // Fetch the character and color representation of the cell type
-      const auto cellType = data.grid[viewTop + y][viewLeft + x];
-      const auto &[ch, baseColor] = cellTypeToCharColor[cellType];
-      const auto color =
-          (cellType == CellType::GOBLIN || cellType == CellType::ORC ||
-           cellType == CellType::DRAGON || cellType == CellType::TROLL ||
-           cellType == CellType::SKELETON)
-              ? enemyColor
-              : baseColor;
-
-      // Calculate distance from player for fog-of-war and halo effects
-      int dx = x - playerScreenX;
-      int dy = y - playerScreenY;
-      int distSq = dx * dx + dy * dy;
-      bool isNearPlayer = distSq <= visionRadius * visionRadius;
-      bool isInHalo = distSq <= haloRadius * haloRadius && distSq > 0;
-
-      // Set color attribute, print the character and unset color attribute
-      // Player gets bold+reverse for maximum visibility
-      if (cellType == CellType::PLAYER) {
-        attron(A_BOLD | A_REVERSE | COLOR_PAIR(static_cast<int>(color)));
-        mvaddch(boardPanel.top + 1 + y, boardPanel.left + 1 + x, ch);
-        attroff(A_BOLD | A_REVERSE | COLOR_PAIR(static_cast<int>(color)));
-      } else if (cellType == CellType::TREASURE || cellType == CellType::POTION) {
-        // Treasures and potions should not be rendered outside vision radius
-        if (isNearPlayer) {
-          // Items get bold for visibility
+  // Walk the viewport one storage tile at a time (the whole viewport for a
+  // dense map), reading row slices straight out of both layers
+  data.terrain->forEachChunk(viewLeft, viewTop, boardWidth, boardHeight,
+                             [&](int originX, int originY,
+                                 GridView<const CellType> terrainTile) {
+    GridView<const CellType> occupantTile = data.occupants->regionView(
+        originX, originY, terrainTile.getWidth(), terrainTile.getHeight());
+    for (unsigned int tileY = 0; tileY < terrainTile.getHeight(); ++tileY) {
+      const int y = originY - viewTop + static_cast<int>(tileY);
+      const CellType *terrainRow = terrainTile.row(tileY);
+      const CellType *occupantRow = occupantTile.row(tileY);
+      for (unsigned int tileX = 0; tileX < terrainTile.getWidth(); ++tileX) {
+        const int x = originX - viewLeft + static_cast<int>(tileX);
+        // Fetch the character and color representation of the cell type
+        const auto cellType = occupantRow[tileX] != CellType::EMPTY
+                                  ? occupantRow[tileX]
+                                  : terrainRow[tileX];
+        const auto &[ch, baseColor] = cellTypeToCharColor[cellType];
+        const auto color =
+            hasTrait(cellType, CellTrait::Monster) ? enemyColor : baseColor;
+
+        // Calculate distance from player for fog-of-war and halo effects
+        int dx = x - playerScreenX;
+        int dy = y - playerScreenY;
+        int distSq = dx * dx + dy * dy;
+        bool isNearPlayer =
+            distSq <= visionRadius * visionRadius &&
+            (data.playerView == nullptr ||
+             data.playerView->isVisible(Point(x + viewLeft, y + viewTop)));
+        bool isInHalo = distSq <= haloRadius * haloRadius && distSq > 0;
+
+        // Set color attribute, print the character and unset color attribute
+        // Player gets bold+reverse for maximum visibility
+        if (cellType == CellType::PLAYER) {
+          attron(A_BOLD | A_REVERSE | COLOR_PAIR(static_cast<int>(color)));
+          mvaddch(boardPanel.top + 1 + y, boardPanel.left + 1 + x, ch);
+          attroff(A_BOLD | A_REVERSE | COLOR_PAIR(static_cast<int>(color)));
+        } else if (hasTrait(cellType, CellTrait::Pickup)) {
+          // Treasures and potions should not be rendered outside vision radius
+          if (isNearPlayer) {
+            // Items get bold for visibility
+            int attrs = A_BOLD | COLOR_PAIR(static_cast<int>(color));
+            if (isInHalo) attrs |= A_STANDOUT;  // Halo effect - standout near player
+            attron(attrs);
+            mvaddch(boardPanel.top + 1 + y, boardPanel.left + 1 + x, ch);
+            attroff(attrs);
+          } else {
+            // Render floor instead when outside vision radius
+            renderHiddenFloor(y, x);
+          }
+        } else if (cellType == CellType::END || cellType == CellType::DOOR) {
+          // Doors and interactive objects get bold + blink for visibility
           int attrs = A_BOLD | COLOR_PAIR(static_cast<int>(color));
           if (isInHalo) attrs |= A_STANDOUT;  // Halo effect - standout near player
+          else if (!isNearPlayer) attrs |= A_DIM;
           attron(attrs);
           mvaddch(boardPanel.top + 1 + y, boardPanel.left + 1 + x, ch);
           attroff(attrs);
-        } else {
-          // Render floor instead when outside vision radius
-          renderHiddenFloor(y, x);
-        }
-      } else if (cellType == CellType::END || cellType == CellType::DOOR) {
-        // Doors and interactive objects get bold + blink for visibility
-        int attrs = A_BOLD | COLOR_PAIR(static_cast<int>(color));
-        if (isInHalo) attrs |= A_STANDOUT;  // Halo effect - standout near player
-        else if (!isNearPlayer) attrs |= A_DIM;
-        attron(attrs);
-        mvaddch(boardPanel.top + 1 + y, boardPanel.left + 1 + x, ch);
-        attroff(attrs);
-      } else if (cellType == CellType::GOBLIN || cellType == CellType::ORC ||
-                 cellType == CellType::DRAGON || cellType == CellType::TROLL ||
-                 cellType == CellType::SKELETON) {
-        // Enemies should not be rendered outside vision radius
-        if (isNearPlayer) {
-          // Enemies get bold for threatening appearance
+        } else if (hasTrait(cellType, CellTrait::Monster)) {
+          // Enemies should not be rendered outside vision radius
+          if (isNearPlayer) {
+            // Enemies get bold for threatening appearance
+            int attrs = A_BOLD | COLOR_PAIR(static_cast<int>(color));
+            if (isInHalo) attrs |= A_STANDOUT;  // Highlight enemies in halo
+            attron(attrs);
+            mvaddch(boardPanel.top + 1 + y, boardPanel.left + 1 + x, ch);
+            attroff(attrs);
+          } else {
+            // Render floor instead when outside vision radius
+            renderHiddenFloor(y, x);
+          }
+        } else if (cellType == CellType::FLOOR && isInHalo) {
+          // Floor tiles in player's halo get brightened (faint halo effect)
           int attrs = A_BOLD | COLOR_PAIR(static_cast<int>(color));
-          if (isInHalo) attrs |= A_STANDOUT;  // Highlight enemies in halo
           attron(attrs);
           mvaddch(boardPanel.top + 1 + y, boardPanel.left + 1 + x, ch);
           attroff(attrs);
         } else {
-          // Render floor instead when outside vision radius
-          renderHiddenFloor(y, x);
-        }
-      } else if (cellType == CellType::FLOOR && isInHalo) {
-        // Floor tiles in player's halo get brightened (faint halo effect)
-        int attrs = A_BOLD | COLOR_PAIR(static_cast<int>(color));
-        attron(attrs);
-        mvaddch(boardPanel.top + 1 + y, boardPanel.left + 1 + x, ch);
-        attroff(attrs);
-      } else {
-        // Terrain and walls - apply fog-of-war dimming for distant tiles
-        int attrs = COLOR_PAIR(static_cast<int>(color));
-        if (!isNearPlayer) {
-          attrs |= A_DIM;
+          // Terrain and walls - apply fog-of-war dimming for distant tiles
+          int attrs = COLOR_PAIR(static_cast<int>(color));
+          if (!isNearPlayer) {
+            attrs |= A_DIM;
+          }
+          attron(attrs);
+          mvaddch(boardPanel.top + 1 + y, boardPanel.left + 1 + x, ch);
+          attroff(attrs);
         }
-        attron(attrs);
-        mvaddch(boardPanel.top + 1 + y, boardPanel.left + 1 + x, ch);
-        attroff(attrs);
       }
     }
-  }
+  });
   
   // Render spell effects on top of the board
   if (data.spellEffects != nullptr) {
@@ -674,8 +691,9 @@ void GameBoardRenderer::drawStats() {
            data.playerPosition.y);
   
   // Get map dimensions from grid
-  int mapHeight = static_cast<int>(data.grid.size());
-  int mapWidth = data.grid.empty() ? 0 : static_cast<int>(data.grid[0].size());
+  int mapHeight =
+      data.terrain ? static_cast<int>(data.terrain->getHeight()) : 0;
+  int mapWidth = data.terrain ? static_cast<int>(data.terrain->getWidth()) : 0;
   mvprintw(y++, xStart, " Map: %d x %d", mapWidth, mapHeight);
   attroff(COLOR_PAIR(static_cast<int>(ColorPair::UI_ACCENT)));
 
@@ -1,6 +1,7 @@
 #ifndef RENDERER_DATA_H
 #define RENDERER_DATA_H
 
+#include "model/cell_layer.h"
 #include "utils/game_settings.h"
 #include "utils/info_deque.h"
 #include "utils/point.h"
@@ -10,6 +11,7 @@
 #include <vector>
 
 // Forward declaration
+class FieldOfView;
 class SpellEffect;
 class Trap;
 
@@ -18,22 +20,28 @@ struct RendererData {
 RendererData holds references to the original objects, so changes to the objects
 in RendererData will affect the original objects, and vice versa.
 */
-  std::vector<std::vector<CellType>> &grid;
+  const CellLayer *terrain;
+  const CellLayer *occupants;
   InfoDeque &messageQueue;
   std::unordered_map<std::string, std::string> &stats;
   Point &playerPosition;
   std::vector<std::shared_ptr<SpellEffect>> *spellEffects;
   std::vector<std::shared_ptr<Trap>> *traps;
+  // Player's field of view; without one, everything within the vision
+  // radius counts as seen, walls or not.
+  const FieldOfView *playerView;
 
-  RendererData(std::vector<std::vector<CellType>> &_grid,
+  RendererData(const CellLayer *_terrain, const CellLayer *_occupants,
                InfoDeque &_messageQueue,
                std::unordered_map<std::string, std::string> &_stats,
                Point &_playerPosition,
                std::vector<std::shared_ptr<SpellEffect>> *_spellEffects = nullptr,
-               std::vector<std::shared_ptr<Trap>> *_traps = nullptr
+               std::vector<std::shared_ptr<Trap>> *_traps = nullptr,
+               const FieldOfView *_playerView = nullptr
                )
-      : grid(_grid), messageQueue(_messageQueue), stats(_stats),
-        playerPosition(_playerPosition), spellEffects(_spellEffects), traps(_traps) {}
+      : terrain(_terrain), occupants(_occupants), messageQueue(_messageQueue), stats(_stats),
+        playerPosition(_playerPosition), spellEffects(_spellEffects), traps(_traps),
+        playerView(_playerView) {}
 };
 
 #endif // RENDERER_DATA_H
@@ -0,0 +1,57 @@
+#ifndef ALIGNED_BUFFER_H
+#define ALIGNED_BUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Fixed-size heap array whose first element sits on an `Alignment` byte
+// boundary (a cache line by default). Used for the flat map layers so that
+// row scans start on a line and never straddle two allocations.
+template <typename T, std::size_t Alignment = 64> class AlignedBuffer {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "AlignedBuffer only holds trivially copyable cells");
+  static_assert((Alignment & (Alignment - 1)) == 0,
+                "Alignment must be a power of two");
+
+  struct Deleter {
+    void operator()(T *pointer) const {
+      ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+  };
+
+  std::unique_ptr<T, Deleter> storage;
+  std::size_t count = 0;
+
+public:
+  AlignedBuffer() = default;
+  explicit AlignedBuffer(std::size_t size, T value = T()) {
+    assign(size, value);
+  }
+
+  // Reallocates only when the size changes; contents are overwritten.
+  void assign(std::size_t size, T value) {
+    if (size != count) {
+      storage.reset();
+      count = 0;
+      if (size > 0) {
+        storage.reset(static_cast<T *>(
+            ::operator new(size * sizeof(T), std::align_val_t(Alignment))));
+        count = size;
+      }
+    }
+    std::fill_n(storage.get(), count, value);
+  }
+
+  T *data() { return storage.get(); }
+  const T *data() const { return storage.get(); }
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  T &operator[](std::size_t index) { return storage.get()[index]; }
+  const T &operator[](std::size_t index) const { return storage.get()[index]; }
+};
+
+#endif // ALIGNED_BUFFER_H
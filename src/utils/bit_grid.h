@@ -0,0 +1,194 @@
+#ifndef BIT_GRID_H
+#define BIT_GRID_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One bit per cell, packed row by row into 64-bit words. Bit x of a row
+// lives in word x / 64 at position x % 64, so a single load answers 64
+// horizontally adjacent cells. Rows are padded to whole words and padding
+// bits are always zero, which lets callers combine rows with plain bitwise
+// operators without masking the tail.
+class BitGrid {
+public:
+  using Word = std::uint64_t;
+  static constexpr int wordBits = 64;
+
+  BitGrid() = default;
+  BitGrid(unsigned int _width, unsigned int _height, bool value = false) {
+    reset(_width, _height, value);
+  }
+
+  void reset(unsigned int _width, unsigned int _height, bool value = false) {
+    width = _width;
+    height = _height;
+    wordsPerRow = (width + wordBits - 1) / wordBits;
+    words.assign(static_cast<std::size_t>(wordsPerRow) * height, 0);
+    if (value) {
+      fill(true);
+    }
+  }
+
+  void fill(bool value) {
+    std::fill(words.begin(), words.end(), value ? ~Word(0) : Word(0));
+    if (value) {
+      clearPadding();
+    }
+  }
+
+  unsigned int getWidth() const { return width; }
+  unsigned int getHeight() const { return height; }
+  unsigned int getWordsPerRow() const { return wordsPerRow; }
+
+  bool contains(int x, int y) const {
+    return x >= 0 && y >= 0 && x < static_cast<int>(width) &&
+           y < static_cast<int>(height);
+  }
+
+  // Out-of-range reads answer false.
+  bool test(int x, int y) const {
+    if (!contains(x, y)) {
+      return false;
+    }
+    return (row(y)[x / wordBits] >> (x % wordBits)) & 1u;
+  }
+
+  void set(int x, int y, bool value) {
+    Word &word = row(y)[x / wordBits];
+    const Word bit = Word(1) << (x % wordBits);
+    word = value ? (word | bit) : (word & ~bit);
+  }
+
+  const Word *row(int y) const {
+    return words.data() + static_cast<std::size_t>(y) * wordsPerRow;
+  }
+  Word *row(int y) {
+    return words.data() + static_cast<std::size_t>(y) * wordsPerRow;
+  }
+
+  // Word `index` of row y; rows outside the grid read as all zero.
+  Word word(int index, int y) const {
+    if (y < 0 || y >= static_cast<int>(height) || index < 0 ||
+        index >= static_cast<int>(wordsPerRow)) {
+      return 0;
+    }
+    return row(y)[index];
+  }
+
+  // The 64 cells starting at x in row y, cell x in bit 0. Cells past either
+  // edge read as zero.
+  Word bitsFrom(int x, int y) const {
+    if (x < 0) {
+      return x <= -wordBits ? 0 : bitsFrom(0, y) << -x;
+    }
+    const int index = x / wordBits;
+    const int shift = x % wordBits;
+    Word bits = word(index, y) >> shift;
+    if (shift != 0) {
+      bits |= word(index + 1, y) << (wordBits - shift);
+    }
+    return bits;
+  }
+
+  // Bits of the 4 orthogonal neighbours of (x, y): bit 0 east, 1 west,
+  // 2 south, 3 north. Outside the grid counts as unset.
+  unsigned int neighbours4(int x, int y) const {
+    return static_cast<unsigned int>(test(x + 1, y)) |
+           static_cast<unsigned int>(test(x - 1, y)) << 1 |
+           static_cast<unsigned int>(test(x, y + 1)) << 2 |
+           static_cast<unsigned int>(test(x, y - 1)) << 3;
+  }
+
+  // Number of set cells in [left, right) of row y.
+  int countInRow(int y, int left, int right) const {
+    int count = 0;
+    forEachWordInRow(y, left, right, [&count](int, Word bits) {
+      count += popcount(bits);
+    });
+    return count;
+  }
+
+  bool anyInRow(int y, int left, int right) const {
+    bool found = false;
+    forEachWordInRow(y, left, right,
+                     [&found](int, Word bits) { found |= bits != 0; });
+    return found;
+  }
+
+  // First set cell in [left, right) of row y, or -1.
+  int findInRow(int y, int left, int right) const {
+    int found = -1;
+    forEachWordInRow(y, left, right, [&found](int base, Word bits) {
+      if (found < 0 && bits != 0) {
+        found = base + countTrailingZeros(bits);
+      }
+    });
+    return found;
+  }
+
+  int count() const {
+    int total = 0;
+    for (Word word : words) {
+      total += popcount(word);
+    }
+    return total;
+  }
+
+  static int popcount(Word bits) {
+    return __builtin_popcountll(bits);
+  }
+  static int countTrailingZeros(Word bits) { return __builtin_ctzll(bits); }
+
+  // Calls fn(x) for every set bit of `bits`, where bit 0 stands for cell
+  // `base`.
+  template <typename Fn> static void forEachSetBit(int base, Word bits, Fn &&fn) {
+    while (bits != 0) {
+      fn(base + countTrailingZeros(bits));
+      bits &= bits - 1;
+    }
+  }
+
+private:
+  unsigned int width = 0;
+  unsigned int height = 0;
+  unsigned int wordsPerRow = 0;
+  std::vector<Word> words;
+
+  void clearPadding() {
+    const int tail = width % wordBits;
+    if (tail == 0) {
+      return;
+    }
+    const Word mask = (Word(1) << tail) - 1;
+    for (unsigned int y = 0; y < height; ++y) {
+      row(y)[wordsPerRow - 1] &= mask;
+    }
+  }
+
+  // Calls fn(base, bits) for each word overlapping [left, right) of row y,
+  // with bits outside the range masked off.
+  template <typename Fn>
+  void forEachWordInRow(int y, int left, int right, Fn &&fn) const {
+    left = std::max(left, 0);
+    right = std::min(right, static_cast<int>(width));
+    if (y < 0 || y >= static_cast<int>(height) || left >= right) {
+      return;
+    }
+    const Word *cells = row(y);
+    for (int index = left / wordBits; index * wordBits < right; ++index) {
+      const int base = index * wordBits;
+      Word bits = cells[index];
+      if (left > base) {
+        bits &= ~Word(0) << (left - base);
+      }
+      if (right - base < wordBits) {
+        bits &= (Word(1) << (right - base)) - 1;
+      }
+      fn(base, bits);
+    }
+  }
+};
+
+#endif // BIT_GRID_H
@@ -0,0 +1,86 @@
+#ifndef CELL_TRAITS_H
+#define CELL_TRAITS_H
+
+#include "utils/game_settings.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// How the game rules treat each CellType, as bit flags. Every "is this a
+// monster / can I walk here" question is answered from cellTraitTable so
+// the lists live in exactly one place.
+namespace CellTrait {
+using Flags = std::uint16_t;
+
+constexpr Flags None = 0;
+constexpr Flags Walkable = 1 << 0; // Terrain a walker may stand on
+constexpr Flags Opaque = 1 << 1;   // Terrain that stops walkers and shots
+constexpr Flags Occupant = 1 << 2; // Lives in the occupancy layer
+constexpr Flags Monster = 1 << 3;
+constexpr Flags Movable = 1 << 4;  // Can be pushed by the player
+constexpr Flags Pickup = 1 << 5;   // Player-only item, monsters avoid it
+constexpr Flags Exit = 1 << 6;
+} // namespace CellTrait
+
+constexpr std::size_t cellTypeCount =
+    static_cast<std::size_t>(CellType::ARROW_PROJECTILE) + 1;
+
+constexpr CellTrait::Flags cellTraitsOf(CellType cellType) {
+  switch (cellType) {
+  case CellType::EMPTY:
+  case CellType::FLOOR:
+  case CellType::DOOR:
+  case CellType::GRASS:
+  case CellType::TREE:
+  case CellType::DESERT:
+  case CellType::START:
+    return CellTrait::Walkable;
+  case CellType::END:
+    return CellTrait::Walkable | CellTrait::Exit;
+  case CellType::WALL:
+  case CellType::MOUNTAIN:
+  case CellType::WATER:
+    return CellTrait::Opaque;
+  case CellType::PLAYER:
+    return CellTrait::Occupant;
+  case CellType::GOBLIN:
+  case CellType::ORC:
+  case CellType::TROLL:
+  case CellType::DRAGON:
+  case CellType::SKELETON:
+    return CellTrait::Occupant | CellTrait::Monster;
+  case CellType::TREASURE:
+  case CellType::POTION:
+    return CellTrait::Occupant | CellTrait::Pickup;
+  case CellType::BOULDER:
+  case CellType::CRATE:
+  case CellType::BARREL:
+    return CellTrait::Occupant | CellTrait::Movable;
+  default:
+    return CellTrait::None;
+  }
+}
+
+namespace detail {
+constexpr std::array<CellTrait::Flags, cellTypeCount> makeCellTraitTable() {
+  std::array<CellTrait::Flags, cellTypeCount> table{};
+  for (std::size_t i = 0; i < cellTypeCount; ++i) {
+    table[i] = cellTraitsOf(static_cast<CellType>(i));
+  }
+  return table;
+}
+} // namespace detail
+
+inline constexpr std::array<CellTrait::Flags, cellTypeCount> cellTraitTable =
+    detail::makeCellTraitTable();
+
+// True if the cell has any of the given traits.
+constexpr bool hasTrait(CellType cellType, CellTrait::Flags traits) {
+  return (cellTraitTable[static_cast<std::size_t>(cellType)] & traits) != 0;
+}
+
+static_assert(hasTrait(CellType::FLOOR, CellTrait::Walkable) &&
+                  !hasTrait(CellType::WALL, CellTrait::Walkable),
+              "cell trait table out of sync with CellType");
+
+#endif // CELL_TRAITS_H
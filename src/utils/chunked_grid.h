@@ -0,0 +1,172 @@
+#ifndef CHUNKED_GRID_H
+#define CHUNKED_GRID_H
+
+#include "utils/grid_view.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Sparse 2D grid split into square chunks of 2^ChunkBits cells per side.
+// Every chunk starts out pointing at one shared, read-only chunk filled with
+// the grid's fill value; a private chunk is allocated the first time a
+// different value is written into it. Memory therefore follows the number of
+// touched chunks rather than the bounding box.
+template <typename T, unsigned int ChunkBits = 6> class ChunkedGrid {
+public:
+  static constexpr int chunkSize = 1 << ChunkBits;
+  static constexpr int chunkMask = chunkSize - 1;
+
+  struct alignas(64) Chunk {
+    std::array<T, chunkSize * chunkSize> cells;
+  };
+
+  ChunkedGrid() = default;
+  ChunkedGrid(unsigned int _width, unsigned int _height, T _fillValue) {
+    reset(_width, _height, _fillValue);
+  }
+
+  // Drops every private chunk and refills the grid with one value.
+  void reset(unsigned int _width, unsigned int _height, T _fillValue) {
+    width = _width;
+    height = _height;
+    chunksX = (width + chunkMask) >> ChunkBits;
+    chunksY = (height + chunkMask) >> ChunkBits;
+    fill(_fillValue);
+  }
+
+  void fill(T value) {
+    fillValue = value;
+    if (!sharedChunk) {
+      sharedChunk = std::make_unique<Chunk>();
+    }
+    sharedChunk->cells.fill(value);
+    owned.clear();
+    owned.resize(static_cast<std::size_t>(chunksX) * chunksY);
+    table.assign(owned.size(), sharedChunk.get());
+  }
+
+  T get(int x, int y) const {
+    return table[chunkIndex(x, y)]->cells[cellIndex(x, y)];
+  }
+
+  void set(int x, int y, T value) {
+    const std::size_t chunk = chunkIndex(x, y);
+    if (!owned[chunk]) {
+      if (value == fillValue) {
+        return; // Already reads as the fill value, keep sharing
+      }
+      materialize(chunk);
+    }
+    table[chunk]->cells[cellIndex(x, y)] = value;
+  }
+
+  unsigned int getWidth() const { return width; }
+  unsigned int getHeight() const { return height; }
+  unsigned int getChunksX() const { return chunksX; }
+  unsigned int getChunksY() const { return chunksY; }
+  T getFillValue() const { return fillValue; }
+
+  bool isChunkOwned(unsigned int chunkX, unsigned int chunkY) const {
+    return owned[static_cast<std::size_t>(chunkY) * chunksX + chunkX] !=
+           nullptr;
+  }
+
+  std::size_t ownedChunkCount() const {
+    return static_cast<std::size_t>(
+        std::count_if(owned.begin(), owned.end(),
+                      [](const auto &chunk) { return chunk != nullptr; }));
+  }
+
+  std::size_t memoryUsage() const {
+    return (ownedChunkCount() + 1) * sizeof(Chunk) +
+           owned.size() * (sizeof(owned[0]) + sizeof(table[0]));
+  }
+
+  // View of a rectangle that must not cross a chunk border.
+  GridView<const T> regionView(int left, int top, unsigned int regionWidth,
+                               unsigned int regionHeight) const {
+    const Chunk *chunk = table[chunkIndex(left, top)];
+    return GridView<const T>(chunk->cells.data() + cellIndex(left, top),
+                             regionWidth, regionHeight, chunkSize);
+  }
+
+  // Calls fn(originX, originY, view) once per chunk overlapping the
+  // rectangle, with the view clipped to the rectangle and the grid.
+  template <typename Fn>
+  void forEachChunk(int left, int top, unsigned int regionWidth,
+                    unsigned int regionHeight, Fn &&fn) const {
+    const int right = std::min<int>(left + regionWidth, width);
+    const int bottom = std::min<int>(top + regionHeight, height);
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    for (int y = top; y < bottom; y = (y | chunkMask) + 1) {
+      const int rowEnd = std::min(bottom, (y | chunkMask) + 1);
+      for (int x = left; x < right; x = (x | chunkMask) + 1) {
+        const int columnEnd = std::min(right, (x | chunkMask) + 1);
+        fn(x, y, regionView(x, y, columnEnd - x, rowEnd - y));
+      }
+    }
+  }
+
+  // Like forEachChunk over the whole grid, but skips chunks that still share
+  // the fill value.
+  template <typename Fn> void forEachOwnedChunk(Fn &&fn) const {
+    for (unsigned int chunkY = 0; chunkY < chunksY; ++chunkY) {
+      for (unsigned int chunkX = 0; chunkX < chunksX; ++chunkX) {
+        if (!isChunkOwned(chunkX, chunkY)) {
+          continue;
+        }
+        const int x = static_cast<int>(chunkX) << ChunkBits;
+        const int y = static_cast<int>(chunkY) << ChunkBits;
+        const unsigned int regionWidth =
+            std::min<unsigned int>(chunkSize, width - x);
+        const unsigned int regionHeight =
+            std::min<unsigned int>(chunkSize, height - y);
+        fn(x, y, regionView(x, y, regionWidth, regionHeight));
+      }
+    }
+  }
+
+  // Calls fn(originX, view) for each piece of row y, left to right, that
+  // lies in an owned chunk.
+  template <typename Fn> void forEachOwnedSpanInRow(int y, Fn &&fn) const {
+    const unsigned int chunkY = static_cast<unsigned int>(y) >> ChunkBits;
+    for (unsigned int chunkX = 0; chunkX < chunksX; ++chunkX) {
+      if (!isChunkOwned(chunkX, chunkY)) {
+        continue;
+      }
+      const int x = static_cast<int>(chunkX) << ChunkBits;
+      fn(x, regionView(x, y, std::min<unsigned int>(chunkSize, width - x), 1));
+    }
+  }
+
+private:
+  unsigned int width = 0;
+  unsigned int height = 0;
+  unsigned int chunksX = 0;
+  unsigned int chunksY = 0;
+  T fillValue = T();
+  std::unique_ptr<Chunk> sharedChunk;
+  std::vector<std::unique_ptr<Chunk>> owned;
+  // Chunk every lookup goes through: the owned one or sharedChunk.
+  std::vector<Chunk *> table;
+
+  std::size_t chunkIndex(int x, int y) const {
+    return static_cast<std::size_t>(y >> ChunkBits) * chunksX +
+           (x >> ChunkBits);
+  }
+
+  static std::size_t cellIndex(int x, int y) {
+    return static_cast<std::size_t>(y & chunkMask) * chunkSize +
+           (x & chunkMask);
+  }
+
+  void materialize(std::size_t chunk) {
+    owned[chunk] = std::make_unique<Chunk>(*sharedChunk);
+    table[chunk] = owned[chunk].get();
+  }
+};
+
+#endif // CHUNKED_GRID_H
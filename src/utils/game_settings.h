@@ -1,7 +1,10 @@
 #ifndef GAME_SETTINGS_H
 #define GAME_SETTINGS_H
 
-enum class CellType {
+#include <cstdint>
+
+// One byte per cell so map layers pack tightly.
+enum class CellType : std::uint8_t {
   EMPTY = 0,
   WALL,
   FLOOR,
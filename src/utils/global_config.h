@@ -28,6 +28,15 @@ public:
     throw std::runtime_error("Key not found");
   }
 
+  // Like getConfig, but answers `fallback` for keys the file lacks, so
+  // config files written before a key existed keep working.
+  template <typename T> T getConfigOr(const std::string &key, T fallback) {
+    if (config.find(key) == config.end()) {
+      return fallback;
+    }
+    return getConfig<T>(key);
+  }
+
 private:
   std::map<std::string, std::string> config;
 
@@ -106,7 +115,9 @@ private:
                                                   "PotionMana=35",
                                                   "PotionManaChance=50",
                                                   "BonusValue=50",
-                                                  "BonusExpirationCounter=100"};
+                                                  "BonusExpirationCounter=100",
+                                                  "Seed=0",
+                                                  "LevelCacheSize=8"};
 
         for (const auto &entry : defaultConfig) {
           newConfigFile << entry << "\n";
@@ -0,0 +1,58 @@
+#ifndef GRID_VIEW_H
+#define GRID_VIEW_H
+
+#include "utils/point.h"
+#include <cstddef>
+#include <type_traits>
+
+// Non-owning 2D window over row-major cell storage. Rows are `stride`
+// elements apart so a view can cover padded rows or a sub-rectangle of a
+// larger buffer. Use GridView<const T> for read-only access.
+template <typename T> class GridView {
+  T *cells = nullptr;
+  unsigned int width = 0;
+  unsigned int height = 0;
+  std::size_t stride = 0;
+
+public:
+  GridView() = default;
+  GridView(T *_cells, unsigned int _width, unsigned int _height,
+           std::size_t _stride)
+      : cells(_cells), width(_width), height(_height), stride(_stride) {}
+
+  // A mutable view converts implicitly to a read-only one.
+  template <typename U,
+            typename = std::enable_if_t<std::is_same<const U, T>::value &&
+                                        !std::is_same<U, T>::value>>
+  GridView(const GridView<U> &other)
+      : cells(other.data()), width(other.getWidth()),
+        height(other.getHeight()), stride(other.getStride()) {}
+
+  unsigned int getWidth() const { return width; }
+  unsigned int getHeight() const { return height; }
+  std::size_t getStride() const { return stride; }
+  T *data() const { return cells; }
+  bool empty() const { return width == 0 || height == 0; }
+
+  T *row(int y) const { return cells + static_cast<std::size_t>(y) * stride; }
+  T &operator()(int x, int y) const { return row(y)[x]; }
+  T &operator[](const Point &point) const { return row(point.y)[point.x]; }
+
+  bool contains(int x, int y) const {
+    return x >= 0 && y >= 0 && x < static_cast<int>(width) &&
+           y < static_cast<int>(height);
+  }
+  bool contains(const Point &point) const { return contains(point.x, point.y); }
+
+  // Dense index of a cell, for side tables sized width * height.
+  std::size_t indexOf(int x, int y) const {
+    return static_cast<std::size_t>(y) * width + x;
+  }
+
+  GridView subView(int left, int top, unsigned int subWidth,
+                   unsigned int subHeight) const {
+    return GridView(row(top) + left, subWidth, subHeight, stride);
+  }
+};
+
+#endif // GRID_VIEW_H
@@ -0,0 +1,66 @@
+#ifndef INDEXED_CELL_SET_H
+#define INDEXED_CELL_SET_H
+
+#include "utils/chunked_grid.h"
+#include "utils/point.h"
+#include <cstddef>
+#include <random>
+#include <vector>
+
+// Set of grid cells with O(1) insert, erase, membership and uniform random
+// pick. Members sit in a dense array; a per-cell slot table remembers where,
+// so erasing swaps the last member into the hole. The slot table is chunked
+// so it only costs memory where members have been.
+class IndexedCellSet {
+public:
+  void reset(unsigned int width, unsigned int height) {
+    cells.clear();
+    slots.reset(width, height, -1);
+  }
+
+  bool contains(int x, int y) const { return slots.get(x, y) >= 0; }
+
+  void insert(int x, int y) {
+    if (contains(x, y)) {
+      return;
+    }
+    slots.set(x, y, static_cast<int>(cells.size()));
+    cells.emplace_back(x, y);
+  }
+
+  void erase(int x, int y) {
+    const int slot = slots.get(x, y);
+    if (slot < 0) {
+      return;
+    }
+    const Point last = cells.back();
+    cells[slot] = last;
+    slots.set(last.x, last.y, slot);
+    cells.pop_back();
+    slots.set(x, y, -1);
+  }
+
+  void assign(int x, int y, bool member) {
+    if (member) {
+      insert(x, y);
+    } else {
+      erase(x, y);
+    }
+  }
+
+  std::size_t size() const { return cells.size(); }
+  bool empty() const { return cells.empty(); }
+  const Point &operator[](std::size_t index) const { return cells[index]; }
+
+  // Uniformly random member; the set must not be empty.
+  template <typename Rng> const Point &sample(Rng &rng) const {
+    std::uniform_int_distribution<std::size_t> pick(0, cells.size() - 1);
+    return cells[pick(rng)];
+  }
+
+private:
+  std::vector<Point> cells;
+  ChunkedGrid<int, 6> slots;
+};
+
+#endif // INDEXED_CELL_SET_H
@@ -1,6 +1,7 @@
 #include "point.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 
 Point::Point(int _x, int _y) : x(_x), y(_y) {}
 
@@ -79,8 +80,16 @@ std::ostream &operator<<(std::ostream &os, const Point &p) {
 
 namespace std {
 size_t hash<Point>::operator()(const Point &p) const noexcept {
-  // This hash function is just a basic example and may not provide the best
-  // distribution
-  return hash<int>()(p.x) ^ hash<int>()(p.y);
+  // Pack both coordinates into one word and mix it (MurmurHash3 finaliser),
+  // so nearby points and mirrored points (x, y) / (y, x) land apart
+  std::uint64_t key = static_cast<std::uint64_t>(static_cast<std::uint32_t>(p.x))
+                          << 32 |
+                      static_cast<std::uint32_t>(p.y);
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return static_cast<size_t>(key);
 }
 } // namespace std
@@ -0,0 +1,41 @@
+#ifndef GRID_FIXTURES_H
+#define GRID_FIXTURES_H
+
+#include "utils/bit_grid.h"
+#include <random>
+#include <string>
+#include <vector>
+
+// Grid drawn as rows of characters: '#' is a wall, anything else is open.
+struct AsciiGrid {
+  std::vector<std::string> rows;
+
+  unsigned int width() const { return rows[0].size(); }
+  unsigned int height() const { return rows.size(); }
+  bool isOpen(int x, int y) const { return rows[y][x] != '#'; }
+
+  BitGrid openCells() const {
+    BitGrid cells(width(), height());
+    for (unsigned int y = 0; y < height(); ++y) {
+      for (unsigned int x = 0; x < width(); ++x) {
+        cells.set(x, y, isOpen(x, y));
+      }
+    }
+    return cells;
+  }
+};
+
+// Random walls at roughly the given density, as set bits.
+inline BitGrid scatterWalls(unsigned int width, unsigned int height,
+                            double density, std::mt19937 &rng) {
+  std::bernoulli_distribution wall(density);
+  BitGrid walls(width, height);
+  for (unsigned int y = 0; y < height; ++y) {
+    for (unsigned int x = 0; x < width; ++x) {
+      walls.set(x, y, wall(rng));
+    }
+  }
+  return walls;
+}
+
+#endif // GRID_FIXTURES_H
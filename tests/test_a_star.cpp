@@ -1,8 +1,11 @@
 #include "algorithms/a_star.h"
+#include "grid_fixtures.h"
 #include "utils/game_settings.h"
 #include "gtest/gtest.h"
 #include <climits>
 #include <cmath>
+#include <queue>
+#include <random>
 
 TEST(AStarTest, FindsOnlyPossiblePathInGrid) {
   // Arrange
@@ -54,3 +57,276 @@ TEST(AStarTest, FindsPathInCellTypeEnumGrid) {
   // Assert
   ASSERT_EQ(actualPath, expectedPath);
 }
+
+TEST(AStarTest, WorkspaceIsReusableAcrossSearches) {
+  // Arrange - a wall with a single gap at the bottom
+  const unsigned int width = 12;
+  const unsigned int height = 8;
+  std::vector<int> cells(width * height, 1);
+  for (unsigned int y = 0; y + 1 < height; ++y) {
+    cells[y * width + 6] = 0;
+  }
+  GridView<const int> grid(cells.data(), width, height, width);
+  AStarWorkspace workspace;
+
+  // Act
+  AStar<int> first(workspace, grid, Point(0, 0), Point(11, 0));
+  AStar<int> blocked(workspace, grid, Point(0, 0), Point(6, 0));
+  AStar<int> second(workspace, grid, Point(0, 0), Point(11, 0));
+  AStar<int> fresh(grid, Point(0, 0), Point(11, 0));
+
+  // Assert
+  ASSERT_EQ(first.getPath().size(), 26u); // 11 across + 7 down + 7 up + 1
+  EXPECT_TRUE(blocked.getPath().empty());
+  EXPECT_EQ(second.getPath(), first.getPath());
+  EXPECT_EQ(fresh.getPath(), first.getPath());
+  for (std::size_t i = 1; i < first.getPath().size(); ++i) {
+    const Point step = first.getPath()[i] - first.getPath()[i - 1];
+    EXPECT_EQ(std::abs(step.x) + std::abs(step.y), 1);
+  }
+}
+
+TEST(AStarTest, OpenRoomExpandsOnlyTheStraightLine) {
+  // Arrange
+  std::vector<std::vector<int>> grid(30, std::vector<int>(30, 1));
+
+  // Act
+  AStar<int> aStar(grid, Point(0, 15), Point(29, 15));
+
+  // Assert - deepest-first ties walk straight to the goal
+  EXPECT_EQ(aStar.getPath().size(), 30u);
+  EXPECT_EQ(aStar.getExpandedNodes(), 30u);
+}
+
+namespace {
+// Random walls as the 1 = open, 0 = wall cells AStar reads.
+std::vector<int> scatterCells(unsigned int width, unsigned int height,
+                              std::mt19937 &rng) {
+  const BitGrid walls = scatterWalls(width, height, 0.3, rng);
+  std::vector<int> cells(width * height);
+  for (unsigned int y = 0; y < height; ++y) {
+    for (unsigned int x = 0; x < width; ++x) {
+      cells[y * width + x] = walls.test(x, y) ? 0 : 1;
+    }
+  }
+  return cells;
+}
+
+// Cheapest 8-connected route cost (10 straight, 14 diagonal, no corner
+// cutting), or -1 if unreachable.
+int octileDistance(const std::vector<int> &cells, int width, int height,
+                   Point start, Point end) {
+  auto open = [&](int x, int y) {
+    return x >= 0 && y >= 0 && x < width && y < height &&
+           cells[y * width + x] != 0;
+  };
+  std::vector<int> cost(cells.size(), INT_MAX);
+  using Entry = std::pair<int, int>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  cost[start.y * width + start.x] = 0;
+  queue.emplace(0, start.y * width + start.x);
+  while (!queue.empty()) {
+    auto [g, index] = queue.top();
+    queue.pop();
+    if (g > cost[index])
+      continue;
+    const int x = index % width;
+    const int y = index / width;
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        if ((dx == 0 && dy == 0) || !open(x + dx, y + dy))
+          continue;
+        if (dx != 0 && dy != 0 && (!open(x + dx, y) || !open(x, y + dy)))
+          continue;
+        const int next = (y + dy) * width + x + dx;
+        const int nextCost = g + (dx != 0 && dy != 0 ? 14 : 10);
+        if (nextCost < cost[next]) {
+          cost[next] = nextCost;
+          queue.emplace(nextCost, next);
+        }
+      }
+    }
+  }
+  const int result = cost[end.y * width + end.x];
+  return result == INT_MAX ? -1 : result;
+}
+
+int octileCost(const std::deque<Point> &path) {
+  int cost = 0;
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    const Point step = path[i] - path[i - 1];
+    cost += (step.x != 0 && step.y != 0) ? 14 : 10;
+  }
+  return cost;
+}
+} // namespace
+
+TEST(AStarTest, JumpPointMatchesClassicPathLengths) {
+  const unsigned int width = 24;
+  const unsigned int height = 24;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> coordinate(0, width - 1);
+
+  for (int round = 0; round < 50; ++round) {
+    std::vector<int> cells = scatterCells(width, height, rng);
+    const Point start(coordinate(rng), coordinate(rng));
+    const Point end(coordinate(rng), coordinate(rng));
+    cells[start.y * width + start.x] = 1;
+    cells[end.y * width + end.x] = 1;
+    GridView<const int> grid(cells.data(), width, height, width);
+
+    AStar<int> classic(grid, start, end);
+    AStar<int> jumpPoint(
+        grid, start, end, [](int value) { return value != 0; },
+        AStarMode::JumpPoint);
+
+    const std::deque<Point> path = jumpPoint.getPath();
+    ASSERT_EQ(path.size(), classic.getPath().size()) << "round " << round;
+    if (path.empty())
+      continue;
+    EXPECT_EQ(path.front(), start);
+    EXPECT_EQ(path.back(), end);
+    for (std::size_t i = 1; i < path.size(); ++i) {
+      const Point step = path[i] - path[i - 1];
+      EXPECT_EQ(std::abs(step.x) + std::abs(step.y), 1);
+      EXPECT_EQ(cells[path[i].y * width + path[i].x], 1);
+    }
+  }
+}
+
+TEST(AStarTest, DiagonalJumpPointFindsCheapestOctileRoute) {
+  const int width = 24;
+  const int height = 24;
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<int> coordinate(0, width - 1);
+
+  for (int round = 0; round < 50; ++round) {
+    std::vector<int> cells = scatterCells(width, height, rng);
+    const Point start(coordinate(rng), coordinate(rng));
+    const Point end(coordinate(rng), coordinate(rng));
+    cells[start.y * width + start.x] = 1;
+    cells[end.y * width + end.x] = 1;
+    GridView<const int> grid(cells.data(), width, height, width);
+
+    AStar<int, Connectivity::Eight> jumpPoint(
+        grid, start, end, [](int value) { return value != 0; },
+        AStarMode::JumpPoint);
+
+    const std::deque<Point> path = jumpPoint.getPath();
+    const int expected = octileDistance(cells, width, height, start, end);
+    if (expected < 0) {
+      EXPECT_TRUE(path.empty()) << "round " << round;
+      continue;
+    }
+    ASSERT_FALSE(path.empty()) << "round " << round;
+    EXPECT_EQ(octileCost(path), expected) << "round " << round;
+    EXPECT_EQ(path.front(), start);
+    EXPECT_EQ(path.back(), end);
+    for (std::size_t i = 1; i < path.size(); ++i) {
+      const Point step = path[i] - path[i - 1];
+      ASSERT_LE(std::max(std::abs(step.x), std::abs(step.y)), 1);
+      EXPECT_EQ(cells[path[i].y * width + path[i].x], 1);
+      // No squeezing diagonally between two walls
+      EXPECT_EQ(cells[path[i - 1].y * width + path[i].x], 1);
+      EXPECT_EQ(cells[path[i].y * width + path[i - 1].x], 1);
+    }
+  }
+}
+
+TEST(AStarTest, JumpPointCrossesRoomsWithFewExpansions) {
+  // Arrange - two big rooms joined by a doorway, like an Orc chasing the
+  // player from one room into the next
+  const unsigned int width = 80;
+  const unsigned int height = 40;
+  std::vector<int> cells(width * height, 1);
+  for (unsigned int y = 0; y < height; ++y) {
+    cells[y * width + 40] = y == 30 ? 1 : 0;
+  }
+  GridView<const int> grid(cells.data(), width, height, width);
+  const Point start(5, 5);
+  const Point end(75, 10);
+  auto isOpen = [](int value) { return value != 0; };
+
+  // Act
+  AStar<int> classic(grid, start, end, isOpen);
+  AStar<int> jumpPoint(grid, start, end, isOpen, AStarMode::JumpPoint);
+  AStar<int, Connectivity::Eight> diagonal(grid, start, end, isOpen,
+                                           AStarMode::JumpPoint);
+
+  // Assert
+  EXPECT_EQ(jumpPoint.getPath().size(), classic.getPath().size());
+  EXPECT_FALSE(diagonal.getPath().empty());
+  EXPECT_LE(jumpPoint.getExpandedNodes() * 10, classic.getExpandedNodes());
+  EXPECT_LE(diagonal.getExpandedNodes() * 10, classic.getExpandedNodes());
+}
+
+TEST(AStarTest, EightWayFindsCheapestOctileRoute) {
+  const int width = 24;
+  const int height = 24;
+  std::mt19937 rng(19);
+  std::uniform_int_distribution<int> coordinate(0, width - 1);
+
+  for (int round = 0; round < 50; ++round) {
+    std::vector<int> cells = scatterCells(width, height, rng);
+    const Point start(coordinate(rng), coordinate(rng));
+    const Point end(coordinate(rng), coordinate(rng));
+    cells[start.y * width + start.x] = 1;
+    cells[end.y * width + end.x] = 1;
+    GridView<const int> grid(cells.data(), width, height, width);
+
+    AStar<int, Connectivity::Eight> aStar(grid, start, end);
+
+    const std::deque<Point> path = aStar.getPath();
+    const int expected = octileDistance(cells, width, height, start, end);
+    if (expected < 0) {
+      EXPECT_TRUE(path.empty()) << "round " << round;
+      continue;
+    }
+    ASSERT_FALSE(path.empty()) << "round " << round;
+    EXPECT_EQ(octileCost(path), expected) << "round " << round;
+    EXPECT_EQ(path.front(), start);
+    EXPECT_EQ(path.back(), end);
+  }
+}
+
+TEST(AStarTest, EightWayDoesNotCutCorners) {
+  // Arrange - the only diagonal into the bottom right squeezes between two
+  // walls
+  std::vector<std::vector<int>> grid = {
+      {1, 1, 1}, {1, 1, 0}, {1, 0, 1}};
+
+  // Act
+  AStar<int, Connectivity::Eight> aStar(grid, Point(0, 0), Point(2, 2));
+
+  // Assert
+  EXPECT_TRUE(aStar.getPath().empty());
+}
+
+TEST(AStarTest, EightWayCrossesOpenRoomsFasterThanFourWay) {
+  // Arrange - the two rooms from JumpPointCrossesRoomsWithFewExpansions
+  const unsigned int width = 80;
+  const unsigned int height = 40;
+  std::vector<int> cells(width * height, 1);
+  for (unsigned int y = 0; y < height; ++y) {
+    cells[y * width + 40] = y == 30 ? 1 : 0;
+  }
+  GridView<const int> grid(cells.data(), width, height, width);
+  const Point start(5, 5);
+  const Point end(75, 10);
+
+  // Act
+  AStar<int> fourWay(grid, start, end);
+  AStar<int, Connectivity::Eight> eightWay(grid, start, end);
+  AStar<int, Connectivity::Eight> eightWayJumpPoint(
+      grid, start, end, [](int value) { return value != 0; },
+      AStarMode::JumpPoint);
+
+  // Assert - diagonals save steps, and the octile heuristic keeps the
+  // search from flooding the rooms
+  EXPECT_LT(eightWay.getPath().size(), fourWay.getPath().size());
+  EXPECT_LT(eightWay.getExpandedNodes(), fourWay.getExpandedNodes());
+  EXPECT_EQ(octileCost(eightWayJumpPoint.getPath()),
+            octileCost(eightWay.getPath()));
+  EXPECT_LE(eightWayJumpPoint.getExpandedNodes() * 10,
+            eightWay.getExpandedNodes());
+}
@@ -0,0 +1,103 @@
+#include "algorithms/articulation_points.h"
+#include "grid_fixtures.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+TEST(ArticulationPointsTest, CorridorCellsAreCutRoomCellsAreNot) {
+  // Arrange - two rooms joined by a corridor
+  BitGrid cells = AsciiGrid{{"...#####...",
+                             ".........#.",
+                             "...#####..."}}.openCells();
+  ArticulationPoints points;
+
+  // Act
+  points.build(cells, Point(0, 0), Point(10, 2));
+
+  // Assert
+  for (int x = 3; x <= 7; ++x) {
+    EXPECT_TRUE(points.isCut(Point(x, 1))) << x;
+    EXPECT_TRUE(points.separates(Point(x, 1))) << x;
+  }
+  EXPECT_FALSE(points.isCut(Point(1, 1)));
+  EXPECT_FALSE(points.isCut(Point(9, 0)));
+  EXPECT_TRUE(points.reachesTarget());
+}
+
+TEST(ArticulationPointsTest, LoopsLeaveAWayAround) {
+  // Arrange - a ring around a pillar, with a dead end hanging off it
+  BitGrid cells = AsciiGrid{{".....",
+                             ".###.",
+                             ".....",
+                             "##.##",
+                             "##.##"}}.openCells();
+  ArticulationPoints points;
+
+  // Act
+  points.build(cells, Point(0, 0), Point(4, 2));
+
+  // Assert
+  for (int x = 0; x < 5; ++x) {
+    EXPECT_FALSE(points.separates(Point(x, 0))) << x;
+  }
+  EXPECT_TRUE(points.isCut(Point(2, 2)));
+  EXPECT_TRUE(points.isCut(Point(2, 3)));
+  EXPECT_FALSE(points.isCut(Point(2, 4)));
+  EXPECT_FALSE(points.separates(Point(2, 2)));
+}
+
+TEST(ArticulationPointsTest, RootSplittingTwoBranchesIsCut) {
+  // Arrange
+  BitGrid cells = AsciiGrid{{"#.#",
+                             "...",
+                             "#.#"}}.openCells();
+  ArticulationPoints points;
+
+  // Act
+  points.build(cells, Point(1, 1), Point(1, 0));
+
+  // Assert
+  EXPECT_TRUE(points.isCut(Point(1, 1)));
+  EXPECT_FALSE(points.separates(Point(1, 1)));
+  EXPECT_FALSE(points.isCut(Point(0, 1)));
+}
+
+TEST(ArticulationPointsTest, UnreachableTargetHasNoSeparators) {
+  // Arrange
+  BitGrid cells = AsciiGrid{{"..#..",
+                             "..#.."}}.openCells();
+  ArticulationPoints points;
+
+  // Act
+  points.build(cells, Point(0, 0), Point(4, 1));
+
+  // Assert
+  EXPECT_FALSE(points.reachesTarget());
+  for (int x = 0; x < 5; ++x) {
+    EXPECT_FALSE(points.separates(Point(x, 0)));
+  }
+}
+
+TEST(ArticulationPointsTest, LongCorridorNeedsNoRecursion) {
+  // Arrange - a serpentine corridor tens of thousands of cells long
+  const int width = 301;
+  const int height = 301;
+  BitGrid cells(width, height);
+  for (int y = 0; y < height; y += 2) {
+    for (int x = 0; x < width; ++x) {
+      cells.set(x, y, true);
+    }
+    if (y + 1 < height) {
+      cells.set((y / 2) % 2 == 0 ? width - 1 : 0, y + 1, true);
+    }
+  }
+  ArticulationPoints points;
+
+  // Act
+  points.build(cells, Point(0, 0), Point(width - 1, height - 1));
+
+  // Assert
+  EXPECT_TRUE(points.reachesTarget());
+  EXPECT_TRUE(points.separates(Point(150, 150)));
+  EXPECT_FALSE(points.separates(Point(0, 0)));
+}
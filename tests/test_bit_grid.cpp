@@ -0,0 +1,79 @@
+#include "model/map.h"
+#include "utils/bit_grid.h"
+#include "utils/cell_traits.h"
+#include "gtest/gtest.h"
+
+TEST(BitGridTest, RowQueriesSpanWordBoundaries) {
+  // Arrange
+  BitGrid bits(150, 3);
+  bits.set(0, 1, true);
+  bits.set(63, 1, true);
+  bits.set(64, 1, true);
+  bits.set(149, 1, true);
+
+  // Act & Assert
+  EXPECT_EQ(bits.countInRow(1, 0, 150), 4);
+  EXPECT_EQ(bits.countInRow(1, 1, 149), 2);
+  EXPECT_EQ(bits.findInRow(1, 1, 150), 63);
+  EXPECT_EQ(bits.findInRow(1, 65, 149), -1);
+  EXPECT_FALSE(bits.anyInRow(0, 0, 150));
+  EXPECT_EQ(bits.bitsFrom(63, 1) & 0x3u, 0x3u);
+  EXPECT_EQ(bits.bitsFrom(-1, 1) & 0x3u, 0x2u);
+  EXPECT_FALSE(bits.test(150, 1));
+  EXPECT_FALSE(bits.test(-1, 1));
+}
+
+TEST(BitGridTest, FillLeavesPaddingClear) {
+  BitGrid bits(70, 2, true);
+  EXPECT_EQ(bits.count(), 140);
+  EXPECT_EQ(bits.bitsFrom(64, 0), 0x3Fu);
+  EXPECT_EQ(bits.neighbours4(69, 0), 0x2u | 0x4u);
+}
+
+TEST(BitGridTest, MapBitsFollowSetters) {
+  // Arrange
+  Map map(10, 10);
+  map.clear();
+  Point wall(1, 1);
+  Point crate(2, 2);
+  Point goblin(3, 3);
+
+  // Act
+  map.setCellType(wall, CellType::WALL);
+  map.setCellType(crate, CellType::CRATE);
+  map.setCellType(goblin, CellType::GOBLIN);
+  map.moveOccupant(goblin, Point(4, 3));
+
+  // Assert
+  EXPECT_TRUE(map.opaqueCells().test(1, 1));
+  EXPECT_FALSE(map.walkableCells().test(1, 1));
+  EXPECT_TRUE(map.walkableCells().test(2, 2));
+  EXPECT_TRUE(map.pushableCells().test(2, 2));
+  EXPECT_TRUE(map.occupiedCells().test(2, 2));
+  EXPECT_FALSE(map.occupiedCells().test(3, 3));
+  EXPECT_TRUE(map.occupiedCells().test(4, 3));
+  EXPECT_FALSE(map.pushableCells().test(4, 3));
+}
+
+TEST(BitGridTest, LoadedLevelBitsMatchLayers) {
+  // Arrange
+  Map map(90, 40);
+
+  // Act
+  map.loadLevel();
+  map.setCellType(map.getEnd(), CellType::END);
+  map.setOccupant(map.getStart(), CellType::PLAYER);
+
+  // Assert
+  for (int y = 0; y < static_cast<int>(map.getHeight()); ++y) {
+    for (int x = 0; x < static_cast<int>(map.getWidth()); ++x) {
+      Point p(x, y);
+      ASSERT_EQ(map.walkableCells().test(x, y),
+                hasTrait(map.getTerrain(p), CellTrait::Walkable));
+      ASSERT_EQ(map.opaqueCells().test(x, y),
+                hasTrait(map.getTerrain(p), CellTrait::Opaque));
+      ASSERT_EQ(map.occupiedCells().test(x, y),
+                map.getOccupant(p) != CellType::EMPTY);
+    }
+  }
+}
@@ -0,0 +1,37 @@
+#include "model/map.h"
+#include "utils/cell_traits.h"
+#include "gtest/gtest.h"
+
+TEST(CellTraitsTest, OccupantsAreNeverTerrain) {
+  for (std::size_t i = 0; i < cellTypeCount; ++i) {
+    CellType cell = static_cast<CellType>(i);
+    if (hasTrait(cell, CellTrait::Occupant)) {
+      EXPECT_FALSE(hasTrait(cell, CellTrait::Walkable | CellTrait::Opaque))
+          << "cell " << i;
+    }
+    if (hasTrait(cell, CellTrait::Monster | CellTrait::Movable |
+                           CellTrait::Pickup)) {
+      EXPECT_TRUE(hasTrait(cell, CellTrait::Occupant)) << "cell " << i;
+    }
+  }
+}
+
+TEST(CellTraitsTest, MapAgreesWithTable) {
+  // Arrange
+  Map map(4, 4);
+  map.clear();
+
+  // Act
+  map.setCellType(Point(0, 0), CellType::TREE);
+  map.setCellType(Point(1, 0), CellType::WATER);
+  map.setCellType(Point(2, 0), CellType::END);
+  map.setCellType(Point(3, 0), CellType::BARREL);
+
+  // Assert
+  EXPECT_TRUE(map.isPositionFree(Point(0, 0)));
+  EXPECT_FALSE(map.isPositionFree(Point(1, 0)));
+  EXPECT_FALSE(map.isPositionFree(Point(2, 0)));
+  EXPECT_FALSE(map.isPositionFree(Point(3, 0)));
+  EXPECT_EQ(map.getTerrain(Point(3, 0)), CellType::EMPTY);
+  EXPECT_TRUE(map.pushableCells().test(3, 0));
+}
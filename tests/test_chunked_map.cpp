@@ -0,0 +1,104 @@
+#include "model/cell_layer.h"
+#include "model/map.h"
+#include "utils/chunked_grid.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+TEST(ChunkedMapTest, ChunksAreSharedUntilWritten) {
+  // Arrange
+  ChunkedGrid<CellType, 6> grid(200, 130, CellType::WALL);
+  const auto emptyUsage = grid.memoryUsage();
+
+  // Act - writing the fill value must not allocate anything
+  grid.set(10, 10, CellType::WALL);
+  const auto afterFillWrite = grid.ownedChunkCount();
+  grid.set(70, 5, CellType::FLOOR);
+  grid.set(71, 6, CellType::FLOOR);
+
+  // Assert
+  EXPECT_EQ(afterFillWrite, 0u);
+  EXPECT_EQ(grid.ownedChunkCount(), 1u);
+  EXPECT_TRUE(grid.isChunkOwned(1, 0));
+  EXPECT_FALSE(grid.isChunkOwned(0, 0));
+  EXPECT_GT(grid.memoryUsage(), emptyUsage);
+  EXPECT_EQ(grid.get(70, 5), CellType::FLOOR);
+  EXPECT_EQ(grid.get(72, 5), CellType::WALL);
+  EXPECT_EQ(grid.get(199, 129), CellType::WALL);
+}
+
+TEST(ChunkedMapTest, ForEachChunkCoversRectangleOnce) {
+  // Arrange
+  CellLayer layer(150, 100, MapStorage::Chunked, CellType::EMPTY);
+  std::vector<int> visits(150 * 100, 0);
+
+  // Act - rectangle straddles chunk borders and is clipped by the layer
+  layer.forEachChunk(30, 50, 200, 40,
+                     [&](int originX, int originY,
+                         GridView<const CellType> view) {
+                       for (int y = 0; y < static_cast<int>(view.getHeight());
+                            ++y) {
+                         for (int x = 0; x < static_cast<int>(view.getWidth());
+                              ++x) {
+                           visits[(originY + y) * 150 + originX + x]++;
+                         }
+                       }
+                     });
+
+  // Assert
+  for (int y = 0; y < 100; ++y) {
+    for (int x = 0; x < 150; ++x) {
+      const int expected = (x >= 30 && y >= 50 && y < 90) ? 1 : 0;
+      ASSERT_EQ(visits[y * 150 + x], expected) << x << "," << y;
+    }
+  }
+}
+
+TEST(ChunkedMapTest, ChunkedLevelMatchesDenseReads) {
+  // Arrange
+  Map map(150, 90, MapStorage::Chunked);
+  ASSERT_FALSE(map.terrainLayer().isDense());
+
+  // Act
+  map.loadLevel();
+
+  // Assert - every cell reads the same through the layer and the map
+  const CellLayer &terrain = map.terrainLayer();
+  int floorCells = 0;
+  for (int y = 0; y < static_cast<int>(map.getHeight()); ++y) {
+    for (int x = 0; x < static_cast<int>(map.getWidth()); ++x) {
+      ASSERT_EQ(terrain(x, y), map.getCellType(Point(x, y)));
+      floorCells += terrain(x, y) == CellType::FLOOR;
+    }
+  }
+  EXPECT_GT(floorCells, 0);
+  EXPECT_NE(terrain(map.getStart().x, map.getStart().y), CellType::WALL);
+  EXPECT_NE(terrain(map.getEnd().x, map.getEnd().y), CellType::WALL);
+}
+
+TEST(ChunkedMapTest, SameSeedGivesSameLevelOnEitherStorage) {
+  // Arrange
+  Map dense(300, 200, MapStorage::Dense);
+  Map chunked(300, 200, MapStorage::Chunked);
+
+  // Act
+  dense.loadLevel(1234);
+  chunked.loadLevel(1234);
+
+  // Assert - doors included
+  int doors = 0;
+  for (int y = 0; y < 200; ++y) {
+    for (int x = 0; x < 300; ++x) {
+      ASSERT_EQ(chunked.getCellType(Point(x, y)),
+                dense.getCellType(Point(x, y)))
+          << x << "," << y;
+      doors += dense.getCellType(Point(x, y)) == CellType::DOOR;
+    }
+  }
+  EXPECT_GT(doors, 0);
+}
+
+TEST(ChunkedMapTest, AutoStorageStaysDenseForRegularLevels) {
+  Map small(200, 100);
+  EXPECT_TRUE(small.terrainLayer().isDense());
+  EXPECT_TRUE(small.occupancyLayer().isDense());
+}
@@ -0,0 +1,107 @@
+#include "algorithms/connected_components.h"
+#include "model/map.h"
+#include "gtest/gtest.h"
+
+TEST(ConnectedComponentsTest, LabelsSeparateRegions) {
+  // Arrange - three open regions split by walls
+  BitGrid cells(9, 3, true);
+  for (int y = 0; y < 3; ++y) {
+    cells.set(3, y, false);
+    cells.set(6, y, false);
+  }
+  ConnectedComponents components;
+
+  // Act
+  components.build(cells);
+
+  // Assert
+  EXPECT_EQ(components.componentCount(), 3u);
+  EXPECT_TRUE(components.connected(Point(0, 0), Point(2, 2)));
+  EXPECT_FALSE(components.connected(Point(0, 0), Point(4, 0)));
+  EXPECT_FALSE(components.connected(Point(0, 0), Point(3, 0)));
+}
+
+TEST(ConnectedComponentsTest, AddedCellsMergeComponents) {
+  // Arrange
+  BitGrid cells(9, 3, true);
+  for (int y = 0; y < 3; ++y) {
+    cells.set(3, y, false);
+    cells.set(6, y, false);
+  }
+  ConnectedComponents components;
+  components.build(cells);
+
+  // Act - open both walls
+  cells.set(3, 1, true);
+  components.add(cells, Point(3, 1));
+  cells.set(6, 2, true);
+  components.add(cells, Point(6, 2));
+
+  // Assert
+  EXPECT_EQ(components.componentCount(), 1u);
+  EXPECT_TRUE(components.connected(Point(0, 0), Point(8, 0)));
+}
+
+TEST(ConnectedComponentsTest, IsolatedAddedCellIsItsOwnComponent) {
+  // Arrange
+  BitGrid cells(5, 5);
+  ConnectedComponents components;
+  components.build(cells);
+
+  // Act
+  cells.set(2, 2, true);
+  components.add(cells, Point(2, 2));
+
+  // Assert
+  EXPECT_EQ(components.componentCount(), 1u);
+  EXPECT_TRUE(components.connected(Point(2, 2), Point(2, 2)));
+  EXPECT_FALSE(components.connected(Point(2, 2), Point(1, 2)));
+}
+
+TEST(ConnectedComponentsTest, WallChunksStayUnlabelled) {
+  // Arrange - two small rooms in a large walled grid
+  BitGrid cells(1024, 1024);
+  for (int y = 100; y < 110; ++y) {
+    for (int x = 100; x < 110; ++x) {
+      cells.set(x, y, true);
+      cells.set(x + 800, y + 800, true);
+    }
+  }
+  ConnectedComponents components;
+
+  // Act
+  components.build(cells);
+
+  // Assert - labels for a handful of chunks, not the whole grid
+  EXPECT_EQ(components.componentCount(), 2u);
+  EXPECT_TRUE(components.connected(Point(100, 100), Point(109, 109)));
+  EXPECT_FALSE(components.connected(Point(100, 100), Point(900, 900)));
+  EXPECT_LT(components.memoryUsage(), 1024u * 1024u * sizeof(int) / 16);
+}
+
+TEST(MapComponentsTest, FollowsTerrainWrites) {
+  // Arrange - a wall splitting the map
+  Map map(20, 10);
+  for (int y = 0; y < 10; ++y) {
+    map.setCellType(Point(10, y), CellType::WALL);
+  }
+  EXPECT_FALSE(map.sameComponent(Point(1, 1), Point(18, 8)));
+
+  // Act & Assert - a door joins the halves, a wall splits them again
+  map.setCellType(Point(10, 4), CellType::FLOOR);
+  EXPECT_TRUE(map.sameComponent(Point(1, 1), Point(18, 8)));
+  map.setCellType(Point(10, 4), CellType::WALL);
+  EXPECT_FALSE(map.sameComponent(Point(1, 1), Point(18, 8)));
+  EXPECT_FALSE(map.sameComponent(Point(1, 1), Point(10, 0)));
+}
+
+TEST(MapComponentsTest, GeneratedLevelsReachTheirExit) {
+  for (int round = 0; round < 3; ++round) {
+    // Arrange & Act
+    Map map(120, 90);
+    map.loadLevel();
+
+    // Assert
+    EXPECT_TRUE(map.sameComponent(map.getStart(), map.getEnd()));
+  }
+}
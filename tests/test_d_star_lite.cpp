@@ -0,0 +1,250 @@
+#include "algorithms/d_star_lite.h"
+#include "utils/bit_grid.h"
+#include "gtest/gtest.h"
+#include <deque>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace {
+// Shortest 4-connected path length, -1 if unreachable.
+int breadthFirstLength(const BitGrid &open, const Point &start,
+                       const Point &goal) {
+  const int width = open.getWidth();
+  std::vector<int> distance(open.getWidth() * open.getHeight(), -1);
+  std::queue<Point> frontier;
+  distance[start.y * width + start.x] = 0;
+  frontier.push(start);
+  const Point steps[] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+  while (!frontier.empty()) {
+    const Point current = frontier.front();
+    frontier.pop();
+    if (current == goal) {
+      return distance[current.y * width + current.x];
+    }
+    for (const Point &step : steps) {
+      const Point next = current + step;
+      if (open.test(next.x, next.y) &&
+          distance[next.y * width + next.x] < 0) {
+        distance[next.y * width + next.x] =
+            distance[current.y * width + current.x] + 1;
+        frontier.push(next);
+      }
+    }
+  }
+  return -1;
+}
+
+// Checks the path runs from start to goal through open, adjacent cells.
+void expectValidPath(const std::deque<Point> &path, const BitGrid &open,
+                     const Point &start, const Point &goal) {
+  ASSERT_FALSE(path.empty());
+  EXPECT_EQ(path.front(), start);
+  EXPECT_EQ(path.back(), goal);
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    EXPECT_TRUE(open.test(path[i].x, path[i].y)) << path[i];
+    if (i > 0) {
+      const Point step = path[i] - path[i - 1];
+      EXPECT_EQ(std::abs(step.x) + std::abs(step.y), 1) << path[i];
+    }
+  }
+}
+
+// 60x40 open field with a wall down the middle, open at the bottom.
+BitGrid walledField() {
+  BitGrid open(60, 40, true);
+  for (int y = 0; y < 35; ++y) {
+    open.set(30, y, false);
+  }
+  return open;
+}
+} // namespace
+
+TEST(DStarLiteTest, MatchesBreadthFirstOnRandomGrids) {
+  // Arrange
+  std::mt19937 rng(15);
+  std::bernoulli_distribution wall(0.3);
+
+  for (int round = 0; round < 20; ++round) {
+    BitGrid open(25, 25, true);
+    for (int y = 0; y < 25; ++y) {
+      for (int x = 0; x < 25; ++x) {
+        open.set(x, y, !wall(rng));
+      }
+    }
+    const Point start(0, 0);
+    const Point goal(24, 24);
+    open.set(start.x, start.y, true);
+    open.set(goal.x, goal.y, true);
+    DStarLite planner;
+    planner.reset(open);
+
+    // Act
+    std::deque<Point> path = planner.plan(start, goal);
+
+    // Assert
+    const int expected = breadthFirstLength(open, start, goal);
+    if (expected < 0) {
+      EXPECT_TRUE(path.empty());
+    } else {
+      expectValidPath(path, open, start, goal);
+      EXPECT_EQ(static_cast<int>(path.size()) - 1, expected);
+    }
+  }
+}
+
+TEST(DStarLiteTest, PursuerStepsReuseTheSearch) {
+  // Arrange
+  const BitGrid open = walledField();
+  DStarLite planner;
+  planner.reset(open);
+  const Point goal(55, 5);
+  std::deque<Point> path = planner.plan(Point(5, 5), goal);
+  const std::size_t firstExpansions = planner.getExpandedNodes();
+
+  // Act - walk ten steps down the path, replanning after each
+  std::size_t replanExpansions = 0;
+  for (int i = 0; i < 10; ++i) {
+    const Point next = path[1];
+    path = planner.plan(next, goal);
+    replanExpansions += planner.getExpandedNodes();
+    expectValidPath(path, open, next, goal);
+    EXPECT_EQ(static_cast<int>(path.size()) - 1,
+              breadthFirstLength(open, next, goal));
+  }
+
+  // Assert
+  EXPECT_LT(replanExpansions * 10, firstExpansions);
+}
+
+TEST(DStarLiteTest, FleeingGoalIsFollowedCheaply) {
+  // Arrange
+  const BitGrid open = walledField();
+  DStarLite planner;
+  planner.reset(open);
+  Point start(5, 5);
+  Point goal(55, 5);
+  std::deque<Point> path = planner.plan(start, goal);
+  const std::size_t firstExpansions = planner.getExpandedNodes();
+
+  // Act - both sides keep moving, the goal away from the pursuer
+  std::size_t replanExpansions = 0;
+  for (int i = 0; i < 5; ++i) {
+    start = path[1];
+    goal += Point(0, 1);
+    path = planner.plan(start, goal);
+    replanExpansions += planner.getExpandedNodes();
+
+    // Assert
+    expectValidPath(path, open, start, goal);
+  }
+  EXPECT_LT(replanExpansions * 5, firstExpansions);
+}
+
+TEST(DStarLiteTest, BlockedCellIsRoutedAround) {
+  // Arrange
+  BitGrid open = walledField();
+  DStarLite planner;
+  planner.reset(open);
+  const Point start(25, 37);
+  const Point goal(35, 37);
+  planner.plan(start, goal);
+
+  // Act - close the gap below the wall except for its last row
+  for (int y = 35; y < 39; ++y) {
+    open.set(30, y, false);
+    planner.setNavigable(30, y, false);
+  }
+  std::deque<Point> path = planner.plan(start, goal);
+
+  // Assert
+  expectValidPath(path, open, start, goal);
+  EXPECT_EQ(static_cast<int>(path.size()) - 1,
+            breadthFirstLength(open, start, goal));
+}
+
+TEST(DStarLiteTest, OpenedCellShortensThePath) {
+  // Arrange
+  BitGrid open = walledField();
+  DStarLite planner;
+  planner.reset(open);
+  const Point start(25, 5);
+  const Point goal(35, 5);
+  const std::size_t detour = planner.plan(start, goal).size();
+
+  // Act - knock a door into the wall
+  open.set(30, 5, true);
+  planner.setNavigable(30, 5, true);
+  std::deque<Point> path = planner.plan(start, goal);
+
+  // Assert
+  expectValidPath(path, open, start, goal);
+  EXPECT_EQ(path.size(), 11u);
+  EXPECT_LT(path.size(), detour);
+}
+
+TEST(DStarLiteTest, JumpingGoalStartsOver) {
+  // Arrange
+  const BitGrid open = walledField();
+  DStarLite planner;
+  planner.reset(open);
+  planner.plan(Point(5, 5), Point(55, 5));
+
+  // Act
+  std::deque<Point> path = planner.plan(Point(5, 5), Point(10, 30));
+
+  // Assert
+  expectValidPath(path, open, Point(5, 5), Point(10, 30));
+  EXPECT_EQ(path.size(), 31u);
+}
+
+TEST(DStarLiteTest, UnreachableGoalGivesNoPath) {
+  // Arrange
+  BitGrid open(10, 10, true);
+  for (int y = 0; y < 10; ++y) {
+    open.set(5, y, false);
+  }
+  DStarLite planner;
+  planner.reset(open);
+
+  // Act & Assert
+  EXPECT_TRUE(planner.plan(Point(1, 1), Point(8, 8)).empty());
+  EXPECT_TRUE(planner.plan(Point(1, 1), Point(5, 5)).empty());
+}
+
+TEST(DStarLiteTest, WindowPlansInGridCells) {
+  // Arrange
+  std::mt19937 rng(23);
+  std::bernoulli_distribution wall(0.2);
+  BitGrid open(400, 400);
+  for (int y = 0; y < 400; ++y) {
+    for (int x = 0; x < 400; ++x) {
+      open.set(x, y, !wall(rng));
+    }
+  }
+  BitGrid window(400, 400);
+  for (int y = 170; y <= 230; ++y) {
+    for (int x = 270; x <= 330; ++x) {
+      window.set(x, y, open.test(x, y));
+    }
+  }
+  const Point start(285, 190), goal(315, 212);
+  window.set(start.x, start.y, true);
+  window.set(goal.x, goal.y, true);
+  open.set(start.x, start.y, true);
+  open.set(goal.x, goal.y, true);
+  DStarLite planner;
+  planner.reset(open, Point(300, 200), 30);
+
+  // Act
+  const auto path = planner.plan(start, goal);
+
+  // Assert
+  EXPECT_TRUE(planner.covers(start));
+  EXPECT_FALSE(planner.covers(Point(100, 100)));
+  const int expected = breadthFirstLength(window, start, goal);
+  ASSERT_GT(expected, 0);
+  expectValidPath(path, window, start, goal);
+  EXPECT_EQ(static_cast<int>(path.size()) - 1, expected);
+  EXPECT_TRUE(planner.plan(start, Point(100, 100)).empty());
+}
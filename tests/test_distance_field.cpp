@@ -0,0 +1,147 @@
+#include "algorithms/distance_field.h"
+#include "grid_fixtures.h"
+#include "model/entities/monster.h"
+#include "model/entities/player.h"
+#include "model/map.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+// Follows the field from `from` until it stops, returning the cells visited.
+std::vector<Point> descendAll(const DistanceField &field, Point from) {
+  std::vector<Point> route{from};
+  for (Point step = field.descend(from); step != Point(0, 0);
+       step = field.descend(from)) {
+    from += step;
+    route.push_back(from);
+  }
+  return route;
+}
+} // namespace
+
+TEST(DistanceFieldTest, CountsStepsAroundWalls) {
+  // Arrange
+  AsciiGrid grid{{"..........",
+                  ".########.",
+                  ".#......#.",
+                  ".#.####.#.",
+                  ".#......#.",
+                  "........#."}};
+  DistanceField field;
+
+  // Act
+  field.compute(grid.width(), grid.height(), Point(0, 0), 100,
+                [&grid](int x, int y) { return grid.isOpen(x, y); });
+
+  // Assert
+  EXPECT_EQ(field.distanceAt(Point(0, 0)), 0);
+  EXPECT_EQ(field.distanceAt(Point(9, 0)), 9);
+  EXPECT_EQ(field.distanceAt(Point(0, 5)), 5);
+  EXPECT_EQ(field.distanceAt(Point(2, 4)), 6); // In through the gap at (1, 5)
+  EXPECT_EQ(field.distanceAt(Point(1, 1)), DistanceField::unreached);
+  EXPECT_EQ(field.distanceAt(Point(-1, 0)), DistanceField::unreached);
+}
+
+TEST(DistanceFieldTest, DescendingFollowsAShortestRoute) {
+  // Arrange - the straight line from (4, 2) to the source is walled off
+  AsciiGrid grid{{".........",
+                  ".#######.",
+                  ".#.....#.",
+                  ".#.....#.",
+                  "........."}};
+  DistanceField field;
+  field.compute(grid.width(), grid.height(), Point(4, 0), 100,
+                [&grid](int x, int y) { return grid.isOpen(x, y); });
+  const Point start(4, 2);
+
+  // Act
+  std::vector<Point> route = descendAll(field, start);
+
+  // Assert
+  ASSERT_EQ(route.back(), Point(4, 0));
+  EXPECT_EQ(static_cast<int>(route.size()) - 1, field.distanceAt(start));
+  for (std::size_t i = 1; i < route.size(); ++i) {
+    EXPECT_TRUE(grid.isOpen(route[i].x, route[i].y));
+    EXPECT_EQ(field.distanceAt(route[i]), field.distanceAt(route[i - 1]) - 1);
+  }
+}
+
+TEST(DistanceFieldTest, StopsAtMaxDistance) {
+  // Arrange
+  DistanceField field;
+  auto open = [](int, int) { return true; };
+
+  // Act
+  field.compute(100, 100, Point(50, 50), 3, open);
+
+  // Assert - a 7x7 square, nothing outside it
+  EXPECT_EQ(field.reachedCount(), 49u);
+  EXPECT_EQ(field.distanceAt(Point(53, 47)), 3);
+  EXPECT_EQ(field.distanceAt(Point(54, 50)), DistanceField::unreached);
+}
+
+TEST(DistanceFieldTest, BuffersCoverOnlyTheWindow) {
+  // Arrange
+  DistanceField field;
+  auto open = [](int, int) { return true; };
+
+  // Act - a short range on a huge grid, against its corner and its middle
+  field.compute(8192, 8192, Point(3, 3), 10, open);
+  const int nearCorner = field.distanceAt(Point(0, 13));
+  field.compute(8192, 8192, Point(4000, 4000), 10, open);
+
+  // Assert
+  EXPECT_EQ(nearCorner, 10);
+  EXPECT_EQ(field.reachedCount(), 21u * 21u);
+  EXPECT_EQ(field.distanceAt(Point(3990, 4010)), 10);
+  EXPECT_EQ(field.distanceAt(Point(3, 3)), DistanceField::unreached);
+  EXPECT_LT(field.memoryUsage(), 21u * 21u * 4 * sizeof(int));
+}
+
+TEST(DistanceFieldTest, RecomputeAndClearForgetOldDistances) {
+  // Arrange
+  DistanceField field;
+  auto open = [](int, int) { return true; };
+  field.compute(20, 20, Point(2, 2), 2, open);
+
+  // Act
+  field.compute(20, 20, Point(15, 15), 2, open);
+
+  // Assert
+  EXPECT_EQ(field.distanceAt(Point(2, 2)), DistanceField::unreached);
+  EXPECT_EQ(field.distanceAt(Point(15, 15)), 0);
+  field.clear();
+  EXPECT_EQ(field.distanceAt(Point(15, 15)), DistanceField::unreached);
+  EXPECT_EQ(field.descend(Point(16, 16)), Point(0, 0));
+}
+
+TEST(DistanceFieldTest, TrollWalksAroundWallInsteadOfIntoIt) {
+  // Arrange - a wall between troll and player; steering straight at the
+  // player would walk into it
+  auto map = std::make_shared<Map>(12, 12);
+  for (int y = 0; y < 8; ++y) {
+    map->setCellType(Point(6, y), CellType::WALL);
+  }
+  auto player = std::make_shared<Player>();
+  player->position = Point(8, 3);
+  auto field = std::make_shared<DistanceField>();
+  const BitGrid &walkable = map->walkableCells();
+  field->compute(map->getWidth(), map->getHeight(), player->position, 15,
+                 [&walkable](int x, int y) { return walkable.test(x, y); });
+
+  auto troll = std::make_shared<Troll>(map, player);
+  troll->setChaseField(field);
+  troll->position = Point(4, 3);
+
+  // Act
+  troll->randomizeVelocity();
+  Point velocity = troll->getVelocity();
+
+  // Assert - heads down toward the gap below the wall
+  const Point next = troll->position + velocity;
+  EXPECT_EQ(velocity.y, 1);
+  EXPECT_TRUE(walkable.test(next.x, next.y));
+  EXPECT_EQ(field->distanceAt(next), field->distanceAt(troll->position) - 1);
+}
@@ -0,0 +1,112 @@
+#include "algorithms/field_of_view.h"
+#include "grid_fixtures.h"
+#include "utils/bit_grid.h"
+#include "gtest/gtest.h"
+#include <random>
+
+TEST(FieldOfViewTest, OpenRoomIsVisibleOutToTheRadius) {
+  // Arrange
+  const BitGrid opaque(40, 40);
+  FieldOfView view;
+
+  // Act
+  view.compute(opaque, Point(20, 20), 8);
+
+  // Assert - exactly the cells within the circle
+  for (int y = 0; y < 40; ++y) {
+    for (int x = 0; x < 40; ++x) {
+      const int dx = x - 20;
+      const int dy = y - 20;
+      EXPECT_EQ(view.isVisible(Point(x, y)), dx * dx + dy * dy <= 64)
+          << Point(x, y);
+    }
+  }
+}
+
+TEST(FieldOfViewTest, WallsCastShadows) {
+  // Arrange - a wall segment three cells east of the viewer
+  BitGrid opaque(30, 30);
+  for (int y = 13; y <= 17; ++y) {
+    opaque.set(13, y, true);
+  }
+  FieldOfView view;
+
+  // Act
+  view.compute(opaque, Point(10, 15), 10);
+
+  // Assert
+  EXPECT_TRUE(view.isVisible(Point(13, 15))); // The wall itself
+  EXPECT_FALSE(view.isVisible(Point(14, 15)));
+  EXPECT_FALSE(view.isVisible(Point(18, 15)));
+  EXPECT_TRUE(view.isVisible(Point(7, 15))); // Nothing blocks the west
+}
+
+TEST(FieldOfViewTest, FloorVisibilityIsSymmetric) {
+  std::mt19937 rng(20);
+  const int radius = 7;
+  for (int round = 0; round < 5; ++round) {
+    // Arrange
+    const BitGrid opaque = scatterWalls(20, 20, 0.25, rng);
+    FieldOfView from;
+    FieldOfView back;
+
+    for (int ay = 0; ay < 20; ++ay) {
+      for (int ax = 0; ax < 20; ++ax) {
+        if (opaque.test(ax, ay)) {
+          continue;
+        }
+        // Act
+        from.compute(opaque, Point(ax, ay), radius);
+
+        // Assert - every floor cell A sees, sees A
+        for (int by = 0; by < 20; ++by) {
+          for (int bx = 0; bx < 20; ++bx) {
+            if (opaque.test(bx, by) || !from.isVisible(Point(bx, by))) {
+              continue;
+            }
+            back.compute(opaque, Point(bx, by), radius);
+            ASSERT_TRUE(back.isVisible(Point(ax, ay)))
+                << Point(ax, ay) << " sees " << Point(bx, by);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(FieldOfViewTest, UpdateRecomputesOnlyWhenSomethingChanged) {
+  // Arrange
+  BitGrid opaque(30, 30);
+  FieldOfView view;
+  ASSERT_TRUE(view.update(opaque, Point(10, 10), 6));
+
+  // Act & Assert - same viewer, same radius: cached
+  EXPECT_FALSE(view.update(opaque, Point(10, 10), 6));
+
+  // A wall goes up; the owner invalidates the view
+  opaque.set(12, 10, true);
+  view.invalidate();
+  EXPECT_TRUE(view.update(opaque, Point(10, 10), 6));
+  EXPECT_FALSE(view.isVisible(Point(13, 10)));
+
+  // The viewer moves
+  EXPECT_TRUE(view.update(opaque, Point(13, 12), 6));
+  EXPECT_TRUE(view.isVisible(Point(13, 10)));
+  EXPECT_FALSE(view.isVisible(Point(10, 4))); // Left behind the radius
+}
+
+TEST(FieldOfViewTest, CoversOnlyCellsInRange) {
+  // Arrange
+  const BitGrid opaque(30, 30);
+  FieldOfView view;
+
+  // Act
+  view.compute(opaque, Point(10, 10), 5);
+
+  // Assert
+  EXPECT_TRUE(view.covers(Point(15, 5)));
+  EXPECT_FALSE(view.covers(Point(16, 10)));
+  view.clear();
+  EXPECT_FALSE(view.covers(Point(10, 10)));
+  EXPECT_FALSE(view.isVisible(Point(10, 10)));
+}
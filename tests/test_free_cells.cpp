@@ -0,0 +1,97 @@
+#include "model/map.h"
+#include "model/model.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <vector>
+
+namespace {
+std::size_t countFreeCells(const Map &map) {
+  std::size_t count = 0;
+  for (int y = 0; y < static_cast<int>(map.getHeight()); ++y) {
+    for (int x = 0; x < static_cast<int>(map.getWidth()); ++x) {
+      count += map.isPositionFree(Point(x, y));
+    }
+  }
+  return count;
+}
+} // namespace
+
+TEST(FreeCellsTest, SetTracksEveryChange) {
+  // Arrange
+  Map map(80, 40);
+  map.loadLevel();
+  ASSERT_EQ(map.freeCellCount(), countFreeCells(map));
+
+  // Act - occupy, move, release and re-terrain a few cells
+  Point first = map.randomFreePosition();
+  map.setOccupant(first, CellType::GOBLIN);
+  Point second = map.randomFreePosition();
+  map.setOccupant(second, CellType::TREASURE);
+  Point third = map.randomFreePosition();
+  map.moveOccupant(first, third);
+  map.clearOccupant(second);
+  map.setCellType(map.getEnd(), CellType::END);
+  map.setCellType(second, CellType::WATER);
+
+  // Assert
+  EXPECT_EQ(map.freeCellCount(), countFreeCells(map));
+  EXPECT_TRUE(map.isPositionFree(first));
+  EXPECT_FALSE(map.isPositionFree(second));
+  EXPECT_FALSE(map.isPositionFree(third));
+  EXPECT_FALSE(map.isPositionFree(map.getEnd()));
+}
+
+TEST(FreeCellsTest, SamplingDrainsTheMap) {
+  // Arrange
+  Map map(5, 4);
+  map.clear();
+
+  // Act - every sample must be free, and the map eventually fills up
+  for (int i = 0; i < 20; ++i) {
+    Point p = map.randomFreePosition();
+    ASSERT_TRUE(map.isPositionFree(p));
+    map.setOccupant(p, CellType::POTION);
+  }
+
+  // Assert
+  EXPECT_EQ(map.freeCellCount(), 0u);
+  EXPECT_FALSE(map.isValidPoint(map.randomFreePosition()));
+}
+
+TEST(FreeCellsTest, ModelStopsSpawningWhenTheMapIsFull) {
+  // Arrange - a walled 10x4 room, too small for a whole population
+  const unsigned int width = 12;
+  const unsigned int height = 6;
+  std::vector<CellType> terrain(width * height, CellType::WALL);
+  for (unsigned int y = 1; y < height - 1; ++y) {
+    for (unsigned int x = 1; x < width - 1; ++x) {
+      terrain[y * width + x] = CellType::FLOOR;
+    }
+  }
+  const std::vector<CellType> occupants(width * height, CellType::EMPTY);
+  auto level = std::make_shared<Map>(width, height);
+  ASSERT_TRUE(level->loadCells(
+      GridView<const CellType>(terrain.data(), width, height, width),
+      GridView<const CellType>(occupants.data(), width, height, width),
+      Point(1, 1), Point(10, 4)));
+  Model model;
+  model.restart();
+
+  // Act
+  model.enterLevel(level);
+
+  // Assert - everything spawned sits on the map, and the map is full
+  EXPECT_EQ(level->freeCellCount(), 0u);
+  ASSERT_FALSE(model.monsters.empty());
+  for (const auto &monster : model.monsters) {
+    ASSERT_TRUE(level->isValidPoint(monster->position));
+    EXPECT_EQ(model.monsterAt(monster->position), monster);
+  }
+  for (const auto &[position, treasure] : model.treasures) {
+    EXPECT_TRUE(level->isValidPoint(position));
+  }
+  for (const auto &[position, potion] : model.potions) {
+    EXPECT_TRUE(level->isValidPoint(position));
+  }
+  EXPECT_TRUE(model.traps.empty());
+}
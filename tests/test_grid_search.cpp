@@ -0,0 +1,94 @@
+#include "algorithms/grid_search.h"
+#include "grid_fixtures.h"
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+TEST(GridSearchTest, FourConnectedPathGoesAroundWalls) {
+  // Arrange
+  AsciiGrid grid{{"......",
+                  ".####.",
+                  "......"}};
+  GridSearch<> search;
+  auto open = [&grid](int x, int y) { return grid.isOpen(x, y); };
+
+  // Act
+  const bool found = search.run(grid.width(), grid.height(), Point(0, 1),
+                                open, CellGoal{Point(5, 1)});
+
+  // Assert
+  ASSERT_TRUE(found);
+  std::vector<Point> path = search.path();
+  ASSERT_EQ(path.size(), 8u);
+  EXPECT_EQ(path.front(), Point(0, 1));
+  EXPECT_EQ(path.back(), Point(5, 1));
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    const Point step = path[i] - path[i - 1];
+    EXPECT_EQ(std::abs(step.x) + std::abs(step.y), 1);
+    EXPECT_TRUE(grid.isOpen(path[i].x, path[i].y));
+  }
+}
+
+TEST(GridSearchTest, EightConnectedStepsDiagonally) {
+  // Arrange
+  GridSearch<Connectivity::Eight> search;
+  auto open = [](int, int) { return true; };
+
+  // Act
+  ASSERT_TRUE(search.run(10, 10, Point(1, 1), open, CellGoal{Point(7, 4)}));
+
+  // Assert - as many steps as the longer axis
+  EXPECT_EQ(search.path().size(), 7u);
+}
+
+TEST(GridSearchTest, StopsAtNearestCellMatchingGoal) {
+  // Arrange
+  AsciiGrid grid{{"..........",
+                  "..........",
+                  "........T.",
+                  "T........."}};
+  GridSearch<> search;
+  auto open = [&grid](int x, int y) { return grid.isOpen(x, y); };
+  auto treasure = [&grid](int x, int y) { return grid.rows[y][x] == 'T'; };
+
+  // Act
+  ASSERT_TRUE(
+      search.run(grid.width(), grid.height(), Point(6, 0), open, treasure));
+
+  // Assert
+  EXPECT_EQ(search.path().back(), Point(8, 2));
+}
+
+TEST(GridSearchTest, UnreachableGoalLeavesNoPath) {
+  // Arrange
+  AsciiGrid grid{{"..#..",
+                  "..#..",
+                  "..#.."}};
+  GridSearch<Connectivity::Eight> search;
+  auto open = [&grid](int x, int y) { return grid.isOpen(x, y); };
+
+  // Act
+  const bool found = search.run(grid.width(), grid.height(), Point(0, 0),
+                                open, CellGoal{Point(4, 2)});
+
+  // Assert
+  EXPECT_FALSE(found);
+  EXPECT_TRUE(search.path().empty());
+  EXPECT_EQ(search.reachedCount(), 6u);
+}
+
+TEST(GridSearchTest, ReusedAcrossGridSizes) {
+  // Arrange
+  GridSearch<> search;
+  auto open = [](int, int) { return true; };
+  auto nothing = [](int, int) { return false; };
+
+  // Act & Assert - every run sees only its own cells
+  EXPECT_FALSE(search.run(20, 20, Point(0, 0), open, nothing));
+  EXPECT_EQ(search.reachedCount(), 400u);
+  EXPECT_FALSE(search.run(5, 3, Point(2, 1), open, nothing));
+  EXPECT_EQ(search.reachedCount(), 15u);
+  ASSERT_TRUE(search.run(20, 20, Point(0, 0), open, CellGoal{Point(3, 0)}));
+  EXPECT_EQ(search.path().size(), 4u);
+}
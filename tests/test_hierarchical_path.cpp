@@ -0,0 +1,201 @@
+#include "algorithms/a_star.h"
+#include "algorithms/hierarchical_pathfinder.h"
+#include "algorithms/maze_generator.h"
+#include "grid_fixtures.h"
+#include "model/map.h"
+#include "utils/cell_traits.h"
+#include "gtest/gtest.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+// Reference answer: plain A* over every cell.
+std::size_t plainPathLength(const BitGrid &walkable, Point start, Point goal) {
+  std::vector<int> cells(walkable.getWidth() * walkable.getHeight());
+  for (unsigned int y = 0; y < walkable.getHeight(); ++y) {
+    for (unsigned int x = 0; x < walkable.getWidth(); ++x) {
+      cells[y * walkable.getWidth() + x] = walkable.test(x, y) ? 1 : 0;
+    }
+  }
+  GridView<const int> grid(cells.data(), walkable.getWidth(),
+                           walkable.getHeight(), walkable.getWidth());
+  return AStar<int>(grid, start, goal).getPath().size();
+}
+
+void expectWalkableSteps(const BitGrid &walkable,
+                         const std::vector<Point> &path) {
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    EXPECT_TRUE(walkable.test(path[i].x, path[i].y)) << path[i];
+    if (i > 0) {
+      const Point step = path[i] - path[i - 1];
+      EXPECT_EQ(std::abs(step.x) + std::abs(step.y), 1) << path[i];
+    }
+  }
+}
+} // namespace
+
+TEST(HierarchicalPathTest, CrossesRoomsThroughTheirPortals) {
+  // Arrange - two rooms joined by a corridor with a bend
+  const std::vector<std::string> rows = {"##############",
+                                         "#....#########",
+                                         "#....#########",
+                                         "#.........####",
+                                         "#....####.####",
+                                         "#########.#..#",
+                                         "#########....#",
+                                         "###########..#",
+                                         "##############"};
+  const BitGrid walkable = AsciiGrid{rows}.openCells();
+  const std::vector<MazeRoom> rooms = {{1, 1, 4, 4}, {11, 5, 2, 3}};
+  HierarchicalPathfinder pathfinder;
+  pathfinder.build(walkable, rooms);
+  HierarchicalWorkspace workspace;
+
+  // Act
+  std::vector<Point> path =
+      pathfinder.findPath(workspace, Point(1, 1), Point(12, 7));
+
+  // Assert
+  EXPECT_EQ(pathfinder.getPortalCount(), 2u); // (5, 3) and (10, 6)
+  ASSERT_FALSE(path.empty());
+  EXPECT_EQ(path.front(), Point(1, 1));
+  EXPECT_EQ(path.back(), Point(12, 7));
+  EXPECT_EQ(path.size(), plainPathLength(walkable, Point(1, 1), Point(12, 7)));
+  expectWalkableSteps(walkable, path);
+}
+
+TEST(HierarchicalPathTest, HandlesSameRegionAndUnreachableGoals) {
+  // Arrange
+  const std::vector<std::string> rows = {"#######",
+                                         "#...#.#",
+                                         "#...#.#",
+                                         "#######"};
+  const BitGrid walkable = AsciiGrid{rows}.openCells();
+  HierarchicalPathfinder pathfinder;
+  pathfinder.build(walkable, {{1, 1, 3, 2}});
+  HierarchicalWorkspace workspace;
+
+  // Act / Assert
+  EXPECT_EQ(pathfinder.findPath(workspace, Point(1, 1), Point(3, 2)).size(),
+            4u);
+  EXPECT_EQ(pathfinder.findPath(workspace, Point(2, 2), Point(2, 2)).size(),
+            1u);
+  EXPECT_TRUE(
+      pathfinder.findPath(workspace, Point(1, 1), Point(5, 1)).empty());
+  EXPECT_TRUE(
+      pathfinder.findPath(workspace, Point(1, 1), Point(0, 0)).empty());
+}
+
+TEST(HierarchicalPathTest, GeneratorExportsItsRooms) {
+  // Arrange / Act
+  MazeGenerator generator(200, 150, MazeGeneratorAlgorithm::BSP);
+  const MazeRoomGraph &graph = generator.getRoomGraph();
+  const std::vector<std::string> maze = generator.getMaze();
+
+  // Assert - rooms are carved open and corridors join real rooms
+  ASSERT_GE(graph.rooms.size(), 2u);
+  EXPECT_FALSE(graph.corridors.empty());
+  for (const MazeRoom &room : graph.rooms) {
+    for (int y = room.y; y < room.y + room.height; ++y) {
+      for (int x = room.x; x < room.x + room.width; ++x) {
+        ASSERT_NE(maze[y][x], '#');
+      }
+    }
+  }
+  for (const auto &[from, to] : graph.corridors) {
+    EXPECT_GE(from, 0);
+    EXPECT_LT(from, static_cast<int>(graph.rooms.size()));
+    EXPECT_GE(to, 0);
+    EXPECT_LT(to, static_cast<int>(graph.rooms.size()));
+    EXPECT_NE(from, to);
+  }
+}
+
+TEST(HierarchicalPathTest, MatchesPlainSearchOnGeneratedLevels) {
+  // Arrange
+  Map map(240, 180);
+  map.loadLevel();
+  const BitGrid &walkable = map.walkableCells();
+  const HierarchicalPathfinder &pathfinder = map.getRoomPathfinder();
+  ASSERT_FALSE(map.getRooms().empty());
+  HierarchicalWorkspace workspace;
+
+  std::vector<Point> open;
+  for (unsigned int y = 0; y < map.getHeight(); ++y) {
+    for (unsigned int x = 0; x < map.getWidth(); ++x) {
+      if (walkable.test(x, y)) {
+        open.emplace_back(x, y);
+      }
+    }
+  }
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<std::size_t> pick(0, open.size() - 1);
+
+  // Act / Assert
+  std::vector<Point> exitPath =
+      pathfinder.findPath(workspace, map.getStart(), map.getEnd());
+  EXPECT_EQ(exitPath.size(),
+            plainPathLength(walkable, map.getStart(), map.getEnd()));
+  EXPECT_LT(workspace.getVisitedCells(), open.size());
+  expectWalkableSteps(walkable, exitPath);
+
+  for (int round = 0; round < 20; ++round) {
+    const Point start = open[pick(rng)];
+    const Point goal = open[pick(rng)];
+    std::vector<Point> path = pathfinder.findPath(workspace, start, goal);
+    ASSERT_EQ(path.size(), plainPathLength(walkable, start, goal))
+        << start << " -> " << goal;
+    expectWalkableSteps(walkable, path);
+  }
+}
+
+TEST(HierarchicalPathTest, CorridorSearchesStayInTheirCorridor) {
+  // Arrange - three rooms in a row; the second corridor has a long
+  // dead-end branch
+  const std::vector<std::string> rows = {"#################",
+                                         "#...###...###...#",
+                                         "#...............#",
+                                         "#...###...#.#...#",
+                                         "###########.#####",
+                                         "###########.#####",
+                                         "###########.#####",
+                                         "###########.#####",
+                                         "###########.#####",
+                                         "#################"};
+  const BitGrid walkable = AsciiGrid{rows}.openCells();
+  const std::vector<MazeRoom> rooms = {{1, 1, 3, 3}, {7, 1, 3, 3},
+                                       {13, 1, 3, 3}};
+  HierarchicalPathfinder pathfinder;
+  pathfinder.build(walkable, rooms);
+  HierarchicalWorkspace workspace;
+
+  // Act - from inside the first corridor to the far room
+  std::vector<Point> path =
+      pathfinder.findPath(workspace, Point(5, 2), Point(14, 2));
+
+  // Assert - 3 corridor cells around the start, the goal's room and its
+  // portal; the second corridor is never flooded
+  EXPECT_EQ(path.size(), plainPathLength(walkable, Point(5, 2), Point(14, 2)));
+  expectWalkableSteps(walkable, path);
+  EXPECT_EQ(workspace.getVisitedCells(), 13u);
+}
+
+TEST(HierarchicalPathTest, LabelsOnlyCorridorsOnLargeLevels) {
+  // Arrange
+  Map map(1024, 1024, MapStorage::Chunked);
+
+  // Act
+  map.loadLevel(7);
+
+  // Assert - rooms stay rectangles, so the planner holds well under one
+  // int per cell, and it still finds the exit
+  const HierarchicalPathfinder &pathfinder = map.getRoomPathfinder();
+  EXPECT_LT(pathfinder.memoryUsage(), 1024u * 1024u * sizeof(int));
+  HierarchicalWorkspace workspace;
+  const std::vector<Point> path =
+      pathfinder.findPath(workspace, map.getStart(), map.getEnd());
+  ASSERT_FALSE(path.empty());
+  EXPECT_EQ(path.back(), map.getEnd());
+  expectWalkableSteps(map.walkableCells(), path);
+}
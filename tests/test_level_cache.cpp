@@ -0,0 +1,124 @@
+#include "model/level_cache.h"
+#include "model/map.h"
+#include "gtest/gtest.h"
+#include <memory>
+
+namespace {
+LevelKey keyOf(std::uint32_t seed) {
+  LevelKey key;
+  key.seed = seed;
+  key.width = 10;
+  key.height = 10;
+  return key;
+}
+
+std::shared_ptr<const TerrainSnapshot> snapshotOf(std::uint32_t seed) {
+  auto snapshot = std::make_shared<TerrainSnapshot>();
+  snapshot->seed = seed;
+  return snapshot;
+}
+} // namespace
+
+TEST(LevelCacheTest, SameSeedGeneratesTheSameLevel) {
+  // Arrange
+  Map first(150, 120);
+  Map second(150, 120);
+
+  // Act
+  first.loadLevel(1234);
+  second.loadLevel(1234);
+
+  // Assert - terrain, ends and later random draws all agree
+  EXPECT_EQ(first.getStart(), second.getStart());
+  EXPECT_EQ(first.getEnd(), second.getEnd());
+  EXPECT_EQ(first.snapshotTerrain().tiles, second.snapshotTerrain().tiles);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(first.randomFreePosition(), second.randomFreePosition());
+  }
+}
+
+TEST(LevelCacheTest, RestoredLevelMatchesTheGeneratedOne) {
+  // Arrange
+  Map generated(150, 120);
+  generated.loadLevel(99);
+  const TerrainSnapshot snapshot = generated.snapshotTerrain();
+  Map restored(150, 120);
+
+  // Act
+  ASSERT_TRUE(restored.restoreTerrain(snapshot));
+
+  // Assert
+  EXPECT_EQ(restored.getStart(), generated.getStart());
+  EXPECT_EQ(restored.getEnd(), generated.getEnd());
+  EXPECT_EQ(restored.getRooms().size(), generated.getRooms().size());
+  EXPECT_EQ(restored.freeCellCount(), generated.freeCellCount());
+  EXPECT_TRUE(restored.sameComponent(restored.getStart(), restored.getEnd()));
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(restored.randomFreePosition(), generated.randomFreePosition());
+  }
+  EXPECT_FALSE(Map(20, 20).restoreTerrain(snapshot));
+}
+
+TEST(LevelCacheTest, SnapshotKeepsOnlyCarvedTiles) {
+  // Arrange - a large sparse level on chunked storage
+  Map generated(1024, 1024, MapStorage::Chunked);
+  generated.loadLevel(7);
+  Map restored(1024, 1024, MapStorage::Chunked);
+
+  // Act
+  const TerrainSnapshot snapshot = generated.snapshotTerrain();
+  ASSERT_TRUE(restored.restoreTerrain(snapshot));
+
+  // Assert
+  std::size_t keptCells = 0;
+  for (const TerrainTile &tile : snapshot.tiles) {
+    keptCells += tile.cells.size();
+  }
+  EXPECT_LT(keptCells, std::size_t{1024} * 1024);
+  EXPECT_LE(keptCells * sizeof(CellType),
+            generated.terrainLayer().memoryUsage());
+  EXPECT_EQ(restored.terrainLayer().memoryUsage(),
+            generated.terrainLayer().memoryUsage());
+  for (int y = 0; y < 1024; ++y) {
+    for (int x = 0; x < 1024; ++x) {
+      ASSERT_EQ(restored.getTerrain(Point(x, y)),
+                generated.getTerrain(Point(x, y)));
+    }
+  }
+}
+
+TEST(LevelCacheTest, EvictsTheLeastRecentlyUsedLevel) {
+  // Arrange
+  LevelCache cache(2);
+  cache.insert(keyOf(1), snapshotOf(1));
+  cache.insert(keyOf(2), snapshotOf(2));
+
+  // Act - touch 1, so 2 is the oldest when 3 arrives
+  ASSERT_NE(cache.find(keyOf(1)), nullptr);
+  cache.insert(keyOf(3), snapshotOf(3));
+
+  // Assert
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_NE(cache.find(keyOf(1)), nullptr);
+  EXPECT_EQ(cache.find(keyOf(2)), nullptr);
+  EXPECT_EQ(cache.find(keyOf(3))->seed, 3u);
+  EXPECT_EQ(cache.hitCount(), 3u);
+}
+
+TEST(LevelCacheTest, KeysDifferingInAnyFieldAreDistinct) {
+  // Arrange
+  LevelCache cache;
+  LevelKey key = keyOf(5);
+  cache.insert(key, snapshotOf(5));
+
+  // Act
+  LevelKey wider = key;
+  wider.width = 11;
+  LevelKey otherAlgorithm = key;
+  otherAlgorithm.algorithm = MazeGeneratorAlgorithm::RandomizedPrim;
+
+  // Assert
+  EXPECT_NE(cache.find(key), nullptr);
+  EXPECT_EQ(cache.find(wider), nullptr);
+  EXPECT_EQ(cache.find(otherAlgorithm), nullptr);
+}
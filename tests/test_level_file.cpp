@@ -0,0 +1,142 @@
+#include "model/level_file.h"
+#include "model/model.h"
+#include "gtest/gtest.h"
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace {
+std::string tempPath(const std::string &name) {
+  return ::testing::TempDir() + name;
+}
+
+// Overwrites `length` bytes of the file at `offset`.
+void patchFile(const std::string &path, std::size_t offset, const void *bytes,
+               std::size_t length) {
+  std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(offset);
+  file.write(static_cast<const char *>(bytes), length);
+}
+} // namespace
+
+TEST(LevelFileTest, SavedLevelLoadsBackIdentically) {
+  // Arrange
+  Model original;
+  original.restart();
+  const std::string path = tempPath("round_trip.aqlv");
+
+  // Act
+  ASSERT_TRUE(original.saveLevelFile(path));
+  Model loaded;
+  ASSERT_TRUE(loaded.loadLevelFile(path));
+
+  // Assert
+  ASSERT_EQ(loaded.map->getWidth(), original.map->getWidth());
+  ASSERT_EQ(loaded.map->getHeight(), original.map->getHeight());
+  EXPECT_EQ(loaded.map->getStart(), original.map->getStart());
+  EXPECT_EQ(loaded.map->getEnd(), original.map->getEnd());
+  for (int y = 0; y < static_cast<int>(original.map->getHeight()); ++y) {
+    for (int x = 0; x < static_cast<int>(original.map->getWidth()); ++x) {
+      Point p(x, y);
+      ASSERT_EQ(loaded.map->getTerrain(p), original.map->getTerrain(p));
+      ASSERT_EQ(loaded.map->getOccupant(p), original.map->getOccupant(p));
+    }
+  }
+  EXPECT_EQ(loaded.map->freeCellCount(), original.map->freeCellCount());
+  EXPECT_EQ(loaded.player->position, original.player->position);
+  EXPECT_EQ(loaded.currentLevel, original.currentLevel);
+  ASSERT_EQ(loaded.monsters.size(), original.monsters.size());
+  for (const auto &monster : loaded.monsters) {
+    EXPECT_EQ(loaded.monsterAt(monster->position), monster);
+  }
+  EXPECT_EQ(loaded.treasures.size(), original.treasures.size());
+  EXPECT_EQ(loaded.potions.size(), original.potions.size());
+  EXPECT_EQ(loaded.traps.size(), original.traps.size());
+  EXPECT_EQ(loaded.movableObjects.size(), original.movableObjects.size());
+  std::remove(path.c_str());
+}
+
+TEST(LevelFileTest, RejectsMissingAndForeignFiles) {
+  // Arrange
+  const std::string path = tempPath("not_a_level.aqlv");
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "definitely not a level file, just some text padding it out";
+  }
+  Model model;
+
+  // Act & Assert
+  EXPECT_FALSE(LevelFile(tempPath("missing.aqlv")).isOpen());
+  EXPECT_FALSE(LevelFile(path).isOpen());
+  EXPECT_FALSE(model.loadLevelFile(path));
+  EXPECT_EQ(model.map, nullptr);
+  std::remove(path.c_str());
+}
+
+TEST(LevelFileTest, RejectsUnknownCellsAndOutOfRangePositions) {
+  // Arrange
+  Model original;
+  original.restart();
+  const std::string badCell = tempPath("bad_cell.aqlv");
+  const std::string badPlayer = tempPath("bad_player.aqlv");
+  ASSERT_TRUE(original.saveLevelFile(badCell));
+  ASSERT_TRUE(original.saveLevelFile(badPlayer));
+  ASSERT_TRUE(LevelFile(badCell).isOpen());
+
+  // Act
+  const unsigned char unknownCell = 0xFF;
+  patchFile(badCell, sizeof(LevelFileHeader) + 5, &unknownCell, 1);
+  const std::int32_t outside = original.map->getWidth();
+  patchFile(badPlayer, offsetof(LevelFileHeader, playerX), &outside,
+            sizeof(outside));
+
+  // Assert
+  EXPECT_FALSE(LevelFile(badCell).isOpen());
+  EXPECT_FALSE(LevelFile(badPlayer).isOpen());
+  Model model;
+  EXPECT_FALSE(model.loadLevelFile(badCell));
+  EXPECT_FALSE(model.loadLevelFile(badPlayer));
+  std::remove(badCell.c_str());
+  std::remove(badPlayer.c_str());
+}
+
+TEST(LevelFileTest, RejectsCorruptedRecords) {
+  // Arrange
+  Model original;
+  original.restart();
+  ASSERT_FALSE(original.monsters.empty());
+  ASSERT_FALSE(original.treasures.empty());
+  const std::string badKind = tempPath("bad_kind.aqlv");
+  const std::string badOccupant = tempPath("bad_occupant.aqlv");
+  ASSERT_TRUE(original.saveLevelFile(badKind));
+  ASSERT_TRUE(original.saveLevelFile(badOccupant));
+  const LevelFile saved(badKind);
+  ASSERT_TRUE(saved.isOpen());
+  const std::size_t cells =
+      std::size_t{saved.header().width} * saved.header().height;
+  const std::size_t monstersOffset =
+      (sizeof(LevelFileHeader) + 2 * cells + 3) / 4 * 4;
+  const std::size_t treasuresOffset =
+      monstersOffset + saved.monsters().size() * sizeof(MonsterRecord);
+
+  // Act
+  const std::uint8_t unknownBonus = 9;
+  patchFile(badKind,
+            treasuresOffset + offsetof(TreasureRecord, bonusType),
+            &unknownBonus, 1);
+  // The first monster record now points at the player's cell
+  const std::int32_t playerCell[2] = {original.player->position.x,
+                                      original.player->position.y};
+  patchFile(badOccupant, monstersOffset + offsetof(MonsterRecord, x),
+            playerCell, sizeof(playerCell));
+
+  // Assert
+  EXPECT_FALSE(LevelFile(badOccupant).isOpen());
+  Model model;
+  EXPECT_FALSE(model.loadLevelFile(badKind));
+  EXPECT_FALSE(model.loadLevelFile(badOccupant));
+  EXPECT_EQ(model.map, nullptr);
+  std::remove(badKind.c_str());
+  std::remove(badOccupant.c_str());
+}
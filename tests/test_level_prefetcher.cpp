@@ -0,0 +1,119 @@
+#include "model/level_prefetcher.h"
+#include "utils/cell_traits.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <thread>
+
+namespace {
+LevelKey keyOf(unsigned int width, unsigned int height) {
+  LevelKey key;
+  key.seed = 22;
+  key.width = width;
+  key.height = height;
+  return key;
+}
+
+// A level as loadLevel leaves it, with the exit marked.
+void expectPlayable(const Map &map) {
+  EXPECT_TRUE(map.isValidPoint(map.getStart()));
+  EXPECT_EQ(map.getTerrain(map.getEnd()), CellType::END);
+  EXPECT_TRUE(map.sameComponent(map.getStart(), map.getEnd()));
+  EXPECT_GT(map.freeCellCount(), 0u);
+}
+} // namespace
+
+TEST(LevelPrefetcherTest, TakesThePrefetchedLevel) {
+  // Arrange
+  LevelPrefetcher prefetcher;
+  prefetcher.prefetch(keyOf(120, 90));
+  ASSERT_TRUE(prefetcher.isPending());
+
+  // Act
+  std::shared_ptr<Map> map = prefetcher.take(keyOf(120, 90));
+
+  // Assert
+  ASSERT_NE(map, nullptr);
+  EXPECT_FALSE(prefetcher.isPending());
+  EXPECT_EQ(map->getWidth(), 120u);
+  EXPECT_EQ(map->getHeight(), 90u);
+  expectPlayable(*map);
+}
+
+TEST(LevelPrefetcherTest, GeneratesOnTheSpotWithoutPrefetch) {
+  // Arrange
+  LevelPrefetcher prefetcher;
+
+  // Act
+  std::shared_ptr<Map> map = prefetcher.take(keyOf(100, 80));
+
+  // Assert
+  ASSERT_NE(map, nullptr);
+  expectPlayable(*map);
+}
+
+TEST(LevelPrefetcherTest, DiscardsALevelForAnotherKey) {
+  // Arrange
+  LevelPrefetcher prefetcher;
+  prefetcher.prefetch(keyOf(100, 80));
+
+  // Act
+  std::shared_ptr<Map> map = prefetcher.take(keyOf(120, 90));
+
+  // Assert
+  EXPECT_EQ(map->getWidth(), 120u);
+  EXPECT_EQ(map->getHeight(), 90u);
+  EXPECT_FALSE(prefetcher.isPending());
+  expectPlayable(*map);
+}
+
+TEST(LevelPrefetcherTest, PrefetchingAnotherKeyReplacesThePendingLevel) {
+  // Arrange
+  LevelPrefetcher prefetcher;
+  prefetcher.prefetch(keyOf(100, 80));
+
+  // Act
+  prefetcher.prefetch(keyOf(120, 90));
+  std::shared_ptr<Map> map = prefetcher.take(keyOf(120, 90));
+
+  // Assert
+  EXPECT_EQ(map->getWidth(), 120u);
+  EXPECT_FALSE(prefetcher.isPending());
+}
+
+TEST(LevelPrefetcherTest, AbandonedLevelStillFinishesIntoTheCache) {
+  // Arrange
+  LevelPrefetcher prefetcher;
+  prefetcher.prefetch(keyOf(100, 80));
+  prefetcher.take(keyOf(120, 90));
+
+  // Act - wait for the abandoned build without taking it
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (prefetcher.getCache().size() < 2 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  std::shared_ptr<Map> map = prefetcher.take(keyOf(100, 80));
+
+  // Assert
+  EXPECT_EQ(prefetcher.getCache().hitCount(), 1u);
+  expectPlayable(*map);
+}
+
+TEST(LevelPrefetcherTest, RepeatedKeysAreRestoredFromTheCache) {
+  // Arrange
+  LevelPrefetcher prefetcher;
+  std::shared_ptr<Map> generated = prefetcher.take(keyOf(100, 80));
+
+  // Act
+  prefetcher.prefetch(keyOf(100, 80));
+  std::shared_ptr<Map> restored = prefetcher.take(keyOf(100, 80));
+
+  // Assert
+  EXPECT_EQ(prefetcher.getCache().hitCount(), 1u);
+  EXPECT_EQ(restored->getStart(), generated->getStart());
+  EXPECT_EQ(restored->getEnd(), generated->getEnd());
+  EXPECT_EQ(restored->snapshotTerrain().tiles,
+            generated->snapshotTerrain().tiles);
+  expectPlayable(*restored);
+}
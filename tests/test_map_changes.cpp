@@ -0,0 +1,55 @@
+#include "model/map.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+TEST(MapChangesTest, FeedReportsEachLayerWrite) {
+  // Arrange
+  Map map(20, 20);
+  map.clear();
+  std::vector<CellChange> changes;
+  int subscription =
+      map.subscribe([&changes](const CellChange &change) {
+        changes.push_back(change);
+      });
+
+  // Act
+  map.setCellType(Point(1, 1), CellType::WALL);
+  map.setCellType(Point(1, 1), CellType::WALL); // No change, no event
+  map.setCellType(Point(2, 2), CellType::ORC);
+  map.moveOccupant(Point(2, 2), Point(3, 2));
+  map.unsubscribe(subscription);
+  map.clearOccupant(Point(3, 2));
+
+  // Assert
+  ASSERT_EQ(changes.size(), 4u);
+  EXPECT_EQ(changes[0].point, Point(1, 1));
+  EXPECT_EQ(changes[0].layer, MapLayer::Terrain);
+  EXPECT_EQ(changes[0].before, CellType::EMPTY);
+  EXPECT_EQ(changes[0].after, CellType::WALL);
+  EXPECT_EQ(changes[1].layer, MapLayer::Occupancy);
+  EXPECT_EQ(changes[1].after, CellType::ORC);
+  EXPECT_EQ(changes[2].point, Point(2, 2));
+  EXPECT_EQ(changes[2].after, CellType::EMPTY);
+  EXPECT_EQ(changes[3].point, Point(3, 2));
+  EXPECT_EQ(changes[3].after, CellType::ORC);
+}
+
+TEST(MapChangesTest, WritesDirtyOnlyTheirTile) {
+  // Arrange
+  Map map(40, 20);
+  map.clear();
+  EXPECT_EQ(map.getDirtyTiles().count(), 15); // Bulk clear dirties all
+  map.clearDirtyTiles();
+
+  // Act
+  map.setCellType(Point(17, 9), CellType::GRASS);
+  map.setOccupant(Point(39, 19), CellType::POTION);
+
+  // Assert
+  const BitGrid &dirty = map.getDirtyTiles();
+  EXPECT_EQ(dirty.getWidth(), 5u);
+  EXPECT_EQ(dirty.getHeight(), 3u);
+  EXPECT_EQ(dirty.count(), 2);
+  EXPECT_TRUE(dirty.test(17 / Map::dirtyTileSize, 9 / Map::dirtyTileSize));
+  EXPECT_TRUE(dirty.test(4, 2));
+}
@@ -0,0 +1,138 @@
+#include "algorithms/a_star.h"
+#include "model/map.h"
+#include "utils/game_settings.h"
+#include "gtest/gtest.h"
+#include <cstdint>
+
+TEST(MapStorageTest, CellTypeFitsInOneByte) {
+  EXPECT_EQ(sizeof(CellType), 1u);
+}
+
+TEST(MapStorageTest, RowsAreCacheLineAligned) {
+  // Arrange & Act
+  Map map(70, 5);
+  auto grid = map.terrainLayer().view();
+
+  // Assert
+  EXPECT_EQ(grid.getWidth(), 70u);
+  EXPECT_EQ(grid.getHeight(), 5u);
+  EXPECT_GE(map.getStride(), map.getWidth());
+  EXPECT_EQ(map.getStride() % 64, 0u);
+  for (int y = 0; y < 5; ++y) {
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(grid.row(y)) % 64, 0u);
+  }
+}
+
+TEST(MapStorageTest, ViewReflectsSetCellType) {
+  // Arrange
+  Map map(10, 10);
+  map.clear();
+
+  // Act
+  map.setCellType(Point(3, 7), CellType::WALL);
+  map.setCellType(Point(9, 9), CellType::DOOR);
+
+  // Assert
+  auto grid = map.terrainLayer().view();
+  EXPECT_EQ(grid(3, 7), CellType::WALL);
+  EXPECT_EQ(grid[Point(9, 9)], CellType::DOOR);
+  EXPECT_EQ(grid(0, 0), CellType::EMPTY);
+}
+
+TEST(MapStorageTest, LoadedLevelMatchesGetCellType) {
+  // Arrange
+  Map map(60, 60);
+
+  // Act
+  map.loadLevel();
+
+  // Assert
+  auto grid = map.terrainLayer().view();
+  for (int y = 0; y < static_cast<int>(map.getHeight()); ++y) {
+    for (int x = 0; x < static_cast<int>(map.getWidth()); ++x) {
+      ASSERT_EQ(grid(x, y), map.getCellType(Point(x, y)));
+    }
+  }
+}
+
+TEST(MapStorageTest, AStarRunsOnMapView) {
+  // Arrange
+  Map map(8, 3);
+  map.clear();
+  for (int x = 0; x < 7; ++x) {
+    map.setCellType(Point(x, 1), CellType::WALL);
+  }
+  auto isNavigable = [](CellType cell) { return cell != CellType::WALL; };
+
+  // Act
+  AStar<CellType> aStar(map.terrainLayer(), Point(0, 0), Point(0, 2), isNavigable);
+  auto path = aStar.getPath();
+
+  // Assert - path has to go around the wall through column 7
+  ASSERT_FALSE(path.empty());
+  EXPECT_EQ(path.front(), Point(0, 0));
+  EXPECT_EQ(path.back(), Point(0, 2));
+  EXPECT_EQ(path.size(), 17u);
+}
+
+TEST(MapStorageTest, OccupantsDoNotOverwriteTerrain) {
+  // Arrange
+  Map map(10, 10);
+  map.clear();
+  Point from(2, 2);
+  Point to(3, 2);
+  map.setCellType(from, CellType::GRASS);
+  map.setCellType(to, CellType::DOOR);
+
+  // Act
+  map.setCellType(from, CellType::GOBLIN);
+  map.moveOccupant(from, to);
+
+  // Assert
+  EXPECT_EQ(map.getTerrain(from), CellType::GRASS);
+  EXPECT_EQ(map.getOccupant(from), CellType::EMPTY);
+  EXPECT_EQ(map.getCellType(from), CellType::GRASS);
+  EXPECT_EQ(map.getTerrain(to), CellType::DOOR);
+  EXPECT_EQ(map.getOccupant(to), CellType::GOBLIN);
+  EXPECT_EQ(map.getCellType(to), CellType::GOBLIN);
+  EXPECT_FALSE(map.isPositionFree(to));
+  EXPECT_TRUE(map.isPositionFree(from));
+}
+
+TEST(MapStorageTest, GeneratorCarvesIntoCallerCanvas) {
+  // Arrange - a canvas over a plain byte buffer that counts its writes
+  struct ByteCanvas : MazeCanvas {
+    std::vector<std::uint8_t> cells;
+    int width;
+    std::size_t writes = 0;
+    ByteCanvas(int _width, int height)
+        : cells(static_cast<std::size_t>(_width) * height, 0), width(_width) {}
+    bool isOpen(int x, int y) const override {
+      return cells[y * width + x] != 0;
+    }
+    void open(int x, int y) override {
+      cells[y * width + x] = 1;
+      ++writes;
+    }
+  };
+  ByteCanvas canvas(200, 150);
+
+  // Act
+  MazeGenerator generator(200, 150, MazeGeneratorAlgorithm::BSP, canvas, 7);
+
+  // Assert - rooms land in the caller's buffer; nothing is kept aside
+  EXPECT_TRUE(generator.getMaze().empty());
+  EXPECT_GT(canvas.writes, 0u);
+  ASSERT_FALSE(generator.getRoomGraph().rooms.empty());
+  for (const MazeRoom &room : generator.getRoomGraph().rooms) {
+    for (int y = room.y; y < room.y + room.height; ++y) {
+      for (int x = room.x; x < room.x + room.width; ++x) {
+        ASSERT_TRUE(canvas.isOpen(x, y));
+      }
+    }
+  }
+  EXPECT_TRUE(canvas.isOpen(generator.getStart().first,
+                            generator.getStart().second));
+  EXPECT_TRUE(
+      canvas.isOpen(generator.getEnd().first, generator.getEnd().second));
+}
@@ -128,3 +128,110 @@ TEST_F(MonsterFollowTest, FollowRangeOrdering) {
   EXPECT_LT(8, 10);  // Skeleton range < Orc range
   EXPECT_LT(10, 15); // Orc range < Troll range
 }
+
+TEST_F(MonsterFollowTest, TrollDoesNotFollowPlayerBehindWall) {
+  // Arrange - a wall between the troll and the player, within range
+  for (int y = 15; y <= 35; ++y) {
+    map->setCellType(Point(20, y), CellType::WALL);
+  }
+  auto sight = std::make_shared<FieldOfView>();
+  sight->update(map->opaqueCells(), player->position, 15);
+  auto troll = std::make_shared<Troll>(map, player);
+  troll->setSight(sight);
+  troll->position = Point(15, 25);
+
+  // Act - a random step heads toward the player one time in three
+  int towardPlayer = 0;
+  for (int i = 0; i < 30; ++i) {
+    troll->randomizeVelocity();
+    if (troll->getVelocity() == Point(1, 0)) {
+      ++towardPlayer;
+    }
+  }
+
+  // Assert
+  EXPECT_FALSE(sight->isVisible(troll->position));
+  EXPECT_LT(towardPlayer, 30);
+}
+
+TEST_F(MonsterFollowTest, SameRngReplaysTheSameMoves) {
+  // Arrange - two skeletons out of range, so every move is random
+  auto first = std::make_shared<Skeleton>(map, player);
+  auto second = std::make_shared<Skeleton>(map, player);
+  first->setRng(std::mt19937(42));
+  second->setRng(std::mt19937(42));
+
+  for (int i = 0; i < 50; ++i) {
+    // Act
+    first->position = second->position = Point(2, 2);
+    first->move(Point(3, 3));
+    second->move(Point(3, 3));
+    first->randomizeVelocity();
+    second->randomizeVelocity();
+
+    // Assert
+    ASSERT_EQ(first->getVelocity(), second->getVelocity()) << i;
+  }
+}
+
+TEST_F(MonsterFollowTest, GoblinIgnoresChaseFieldBehindWall) {
+  // Arrange - a short wall the field leads around in four steps, but
+  // which hides the player from the goblin
+  for (int y = 24; y <= 26; ++y) {
+    map->setCellType(Point(22, y), CellType::WALL);
+  }
+  player->position = Point(24, 25);
+  auto sight = std::make_shared<FieldOfView>();
+  sight->update(map->opaqueCells(), player->position, 15);
+  auto field = std::make_shared<DistanceField>();
+  const BitGrid &walkable = map->walkableCells();
+  field->compute(map->getWidth(), map->getHeight(), player->position, 15,
+                 [&walkable](int x, int y) { return walkable.test(x, y); });
+  auto goblin = std::make_shared<Goblin>(map, player);
+  goblin->setChaseField(field);
+  goblin->setSight(sight);
+  goblin->position = Point(21, 25);
+  ASSERT_FALSE(sight->isVisible(goblin->position));
+  ASSERT_LE(field->distanceAt(goblin->position), 5);
+
+  // Act - random steps only match the field's step now and then
+  int alongField = 0;
+  for (int i = 0; i < 30; ++i) {
+    goblin->randomizeVelocity();
+    if (goblin->getVelocity() == field->descend(goblin->position)) {
+      ++alongField;
+    }
+  }
+
+  // Assert
+  EXPECT_LT(alongField, 30);
+}
+
+TEST_F(MonsterFollowTest, OrcPlansDetoursBeyondItsPursuitWindow) {
+  // Arrange - the player is in reach across a wall whose only gap lies
+  // far outside the pursuit's window
+  map = std::make_shared<Map>(200, 60);
+  for (int y = 0; y < 59; ++y) {
+    map->setCellType(Point(100, y), CellType::WALL);
+  }
+  player->position = Point(104, 5);
+  auto service = std::make_shared<PathService>(0);
+  service->setLevel(map);
+  auto orc = std::make_shared<Orc>(map, player, service);
+  orc->position = Point(96, 5);
+
+  // Act - the pursuit fails first, then the whole-level plan is followed
+  for (int step = 0; step < 150 && orc->position != player->position;
+       ++step) {
+    service->deliver();
+    const Point velocity = orc->getVelocity();
+    if (map->walkableCells().test(orc->position.x + velocity.x,
+                                  orc->position.y + velocity.y)) {
+      orc->position += velocity;
+    }
+  }
+
+  // Assert
+  EXPECT_EQ(orc->position, player->position);
+  EXPECT_EQ(service->completedSearches(), 2u);
+}
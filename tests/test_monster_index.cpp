@@ -0,0 +1,65 @@
+#include "model/model.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <thread>
+
+TEST(MonsterIndexTest, EveryMonsterIsFoundAtItsPosition) {
+  // Arrange & Act
+  Model model;
+  model.restart();
+
+  // Assert
+  ASSERT_FALSE(model.monsters.empty());
+  for (const auto &monster : model.monsters) {
+    EXPECT_EQ(model.monsterAt(monster->position), monster);
+  }
+}
+
+TEST(MonsterIndexTest, CellsWithoutMonstersAreEmpty) {
+  // Arrange
+  Model model;
+  model.restart();
+
+  // Act
+  int indexed = 0;
+  for (int y = 0; y < static_cast<int>(model.map->getHeight()); ++y) {
+    for (int x = 0; x < static_cast<int>(model.map->getWidth()); ++x) {
+      auto monster = model.monsterAt(Point(x, y));
+      if (monster) {
+        indexed++;
+        EXPECT_EQ(monster->position, Point(x, y));
+      }
+    }
+  }
+
+  // Assert
+  EXPECT_EQ(indexed, static_cast<int>(model.monsters.size()));
+  EXPECT_EQ(model.monsterAt(Point(-1, 0)), nullptr);
+  EXPECT_EQ(model.monsterAt(model.player->position), nullptr);
+}
+
+TEST(MonsterIndexTest, SurvivorsStayIndexedAfterDeaths) {
+  // Arrange - kill every other monster without going through a fight
+  Model model;
+  model.restart();
+  ASSERT_GE(model.monsters.size(), 2u);
+  std::size_t survivors = 0;
+  for (std::size_t i = 0; i < model.monsters.size(); ++i) {
+    if (i % 2 == 0) {
+      model.monsters[i]->takeDamage(model.monsters[i]->health + 1000);
+    } else {
+      ++survivors;
+    }
+  }
+
+  // Act - let one monster tick pass
+  std::this_thread::sleep_for(std::chrono::milliseconds(600));
+  model.update();
+
+  // Assert
+  ASSERT_EQ(model.monsters.size(), survivors);
+  for (const auto &monster : model.monsters) {
+    EXPECT_TRUE(monster->isAlive());
+    EXPECT_EQ(model.monsterAt(monster->position), monster);
+  }
+}
@@ -0,0 +1,73 @@
+#include "algorithms/maze_generator.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+namespace {
+// A canvas that must not be written from several threads.
+class SerialCanvas : public MazeCanvas {
+  std::vector<std::string> rows;
+  StringMazeCanvas inner;
+
+public:
+  SerialCanvas(int width, int height)
+      : rows(height, std::string(width, '#')), inner(rows) {}
+  bool isOpen(int x, int y) const override { return inner.isOpen(x, y); }
+  void open(int x, int y) override { inner.open(x, y); }
+  const std::vector<std::string> &getRows() const { return rows; }
+};
+
+void expectSameRooms(const MazeRoomGraph &expected,
+                     const MazeRoomGraph &actual) {
+  ASSERT_EQ(actual.rooms.size(), expected.rooms.size());
+  for (std::size_t i = 0; i < expected.rooms.size(); ++i) {
+    EXPECT_EQ(actual.rooms[i].x, expected.rooms[i].x);
+    EXPECT_EQ(actual.rooms[i].y, expected.rooms[i].y);
+    EXPECT_EQ(actual.rooms[i].width, expected.rooms[i].width);
+    EXPECT_EQ(actual.rooms[i].height, expected.rooms[i].height);
+  }
+  EXPECT_EQ(actual.corridors, expected.corridors);
+}
+} // namespace
+
+TEST(ParallelBSPTest, MatchesSerialGeneration) {
+  for (std::uint32_t seed : {1u, 42u, 2024u}) {
+    // Arrange
+    MazeGenerator serial(640, 480, MazeGeneratorAlgorithm::BSP, seed, 1);
+
+    // Act
+    MazeGenerator parallel(640, 480, MazeGeneratorAlgorithm::BSP, seed, 4);
+
+    // Assert
+    EXPECT_EQ(parallel.getMaze(), serial.getMaze()) << "seed " << seed;
+    EXPECT_EQ(parallel.getStart(), serial.getStart());
+    EXPECT_EQ(parallel.getEnd(), serial.getEnd());
+    expectSameRooms(serial.getRoomGraph(), parallel.getRoomGraph());
+  }
+}
+
+TEST(ParallelBSPTest, OddThreadCountsMatchToo) {
+  // Arrange
+  MazeGenerator serial(500, 400, MazeGeneratorAlgorithm::BSP, 7, 1);
+
+  // Act
+  MazeGenerator parallel(500, 400, MazeGeneratorAlgorithm::BSP, 7, 3);
+
+  // Assert
+  EXPECT_EQ(parallel.getMaze(), serial.getMaze());
+  expectSameRooms(serial.getRoomGraph(), parallel.getRoomGraph());
+}
+
+TEST(ParallelBSPTest, SerialOnlyCanvasStillMatches) {
+  // Arrange
+  MazeGenerator reference(640, 480, MazeGeneratorAlgorithm::BSP, 99, 1);
+  SerialCanvas canvas(640, 480);
+
+  // Act - rooms are carved on the calling thread for this canvas
+  MazeGenerator parallel(640, 480, MazeGeneratorAlgorithm::BSP, canvas, 99,
+                         4);
+
+  // Assert
+  EXPECT_EQ(canvas.getRows(), reference.getMaze());
+  expectSameRooms(reference.getRoomGraph(), parallel.getRoomGraph());
+}
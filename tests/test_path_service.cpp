@@ -0,0 +1,130 @@
+#include "model/map.h"
+#include "model/path_service.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <vector>
+
+class PathServiceTest : public ::testing::Test {
+protected:
+  std::shared_ptr<Map> map;
+
+  void SetUp() override {
+    // Open 30x20 field with a wall down the middle, open at the bottom
+    map = std::make_shared<Map>(30, 20);
+    for (int y = 0; y < 17; ++y) {
+      map->setCellType(Point(15, y), CellType::WALL);
+    }
+  }
+};
+
+TEST_F(PathServiceTest, PathsArriveOnlyWhenDelivered) {
+  // Arrange
+  PathService service(0);
+  service.setLevel(map);
+
+  // Act
+  auto request = service.request(Point(2, 2), Point(28, 2));
+
+  // Assert
+  EXPECT_FALSE(request->ready);
+  service.deliver();
+  ASSERT_TRUE(request->ready);
+  ASSERT_FALSE(request->path.empty());
+  EXPECT_EQ(request->path.front(), Point(2, 2));
+  EXPECT_EQ(request->path.back(), Point(28, 2));
+  for (const Point &cell : request->path) {
+    EXPECT_NE(map->getTerrain(cell), CellType::WALL);
+  }
+}
+
+TEST_F(PathServiceTest, IdenticalRequestsShareOneSearch) {
+  // Arrange
+  PathService service(0);
+  service.setLevel(map);
+
+  // Act
+  auto first = service.request(Point(2, 2), Point(28, 2));
+  auto second = service.request(Point(2, 2), Point(28, 2));
+  auto other = service.request(Point(2, 3), Point(28, 2));
+  service.deliver();
+
+  // Assert
+  EXPECT_EQ(service.completedSearches(), 2u);
+  ASSERT_TRUE(first->ready && second->ready && other->ready);
+  EXPECT_EQ(first->path, second->path);
+}
+
+TEST_F(PathServiceTest, DroppedRequestsAreNeverSearched) {
+  // Arrange
+  PathService service(0);
+  service.setLevel(map);
+
+  // Act
+  service.request(Point(2, 2), Point(28, 2)); // Requester gone at once
+  auto kept = service.request(Point(2, 3), Point(28, 3));
+  service.deliver();
+
+  // Assert
+  EXPECT_EQ(service.completedSearches(), 1u);
+  EXPECT_TRUE(kept->ready);
+}
+
+TEST_F(PathServiceTest, NewLevelAnswersQueuedRequestsUnplanned) {
+  // Arrange
+  PathService service(0);
+  service.setLevel(map);
+  auto stale = service.request(Point(2, 2), Point(28, 2));
+
+  // Act
+  service.setLevel(std::make_shared<Map>(30, 20));
+  service.deliver();
+
+  // Assert - the requester is released without a search
+  EXPECT_TRUE(stale->ready);
+  EXPECT_TRUE(stale->path.empty());
+  EXPECT_EQ(service.completedSearches(), 0u);
+}
+
+TEST_F(PathServiceTest, WorkersServeManyRequesters) {
+  // Arrange
+  PathService service(3);
+  service.setLevel(map);
+  std::vector<std::shared_ptr<PathRequest>> requests;
+
+  // Act
+  for (int y = 0; y < 20; ++y) {
+    requests.push_back(service.request(Point(2, y), Point(28, 19 - y)));
+  }
+  service.waitUntilIdle();
+  service.deliver();
+
+  // Assert
+  for (const auto &request : requests) {
+    ASSERT_TRUE(request->ready);
+    ASSERT_FALSE(request->path.empty());
+    EXPECT_EQ(request->path.front(), request->start);
+    EXPECT_EQ(request->path.back(), request->goal);
+  }
+}
+
+TEST_F(PathServiceTest, PursuitRequestsAreSearchedSeparately) {
+  // Arrange
+  PathService service(0);
+  service.setLevel(map);
+  auto pursuit = std::make_shared<DStarLite>();
+  auto plain = service.request(Point(2, 2), Point(28, 2));
+
+  // Act
+  auto chase = service.request(Point(2, 2), Point(28, 2), pursuit);
+  service.deliver();
+  auto next = service.request(Point(2, 3), Point(28, 2), pursuit);
+  service.deliver();
+
+  // Assert
+  EXPECT_EQ(service.completedSearches(), 3u);
+  ASSERT_TRUE(chase->ready && next->ready);
+  EXPECT_EQ(chase->path.size(), plain->path.size());
+  EXPECT_EQ(next->path.front(), Point(2, 3));
+  EXPECT_EQ(next->path.back(), Point(28, 2));
+  EXPECT_TRUE(pursuit->isReady());
+}
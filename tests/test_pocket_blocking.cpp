@@ -1,14 +1,12 @@
+#include "algorithms/grid_search.h"
 #include "model/model.h"
 #include "utils/game_settings.h"
 #include "gtest/gtest.h"
 #include <algorithm>
-#include <queue>
-#include <array>
 
 namespace {
 // Helper function to check if a path exists between two points
 bool hasPath(const std::shared_ptr<Map> &map, const Point &start, const Point &end,
-             const std::unordered_map<Point, std::shared_ptr<MovableObject>> &movableObjects,
              bool treatMovablesAsBlocking = true) {
   if (!map->isValidPoint(start) || !map->isValidPoint(end)) {
     return false;
@@ -36,35 +34,12 @@ bool hasPath(const std::shared_ptr<Map> &map, const Point &start, const Point &e
             (cell == CellType::CRATE || cell == CellType::BARREL || cell == CellType::BOULDER));
   };
   
-  std::queue<Point> frontier;
-  std::vector<std::vector<bool>> visited(
-      map->getHeight(), std::vector<bool>(map->getWidth(), false));
-  
-  frontier.push(start);
-  visited[start.y][start.x] = true;
-  
-  const std::array<Point, 4> directions = {
-      Point{1, 0}, Point{-1, 0}, Point{0, 1}, Point{0, -1}};
-  
-  while (!frontier.empty()) {
-    Point current = frontier.front();
-    frontier.pop();
-    
-    if (current == end) {
-      return true;
-    }
-    
-    for (const auto &dir : directions) {
-      Point next{current.x + dir.x, current.y + dir.y};
-      if (!map->isValidPoint(next) || visited[next.y][next.x]) continue;
-      if (!isWalkable(next) && next != end) continue;
-      
-      visited[next.y][next.x] = true;
-      frontier.push(next);
-    }
-  }
-  
-  return false;
+  GridSearch<> search;
+  return search.run(map->getWidth(), map->getHeight(), start,
+                    [&](int x, int y) {
+                      return isWalkable(Point(x, y)) || Point(x, y) == end;
+                    },
+                    CellGoal{end});
 }
 }  // namespace
 
@@ -103,7 +78,7 @@ TEST(PocketBlockingTest, PathExistsAfterPushing) {
   Point end = model.map->getEnd();
   
   // Assert - path should exist when treating movable objects as pushable
-  bool pathExists = hasPath(model.map, start, end, model.movableObjects, false);
+  bool pathExists = hasPath(model.map, start, end, false);
   EXPECT_TRUE(pathExists);
 }
 
@@ -112,9 +87,9 @@ TEST(PocketBlockingTest, MovableObjectsOnFloorTiles) {
   Model model;
   model.restart();
   
-  // Assert - all movable objects should have valid underlying cells
+  // Assert - all movable objects should stand on walkable terrain
   for (const auto &[pos, obj] : model.movableObjects) {
-    CellType underlying = obj->underlyingCell;
+    CellType underlying = model.map->getTerrain(pos);
     // Underlying cell should be a walkable type (floor, grass, etc.)
     EXPECT_TRUE(underlying == CellType::FLOOR || 
                 underlying == CellType::GRASS || 